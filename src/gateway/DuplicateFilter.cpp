@@ -0,0 +1,75 @@
+/**
+ * DuplicateFilter — Drops mesh rebroadcasts already queued for the satellite
+ * © Mikoshi Ltd. — Apache 2.0
+ */
+
+#include "DuplicateFilter.h"
+#include <string.h>
+
+static_assert((DUPLICATE_FILTER_SLOTS & (DUPLICATE_FILTER_SLOTS - 1)) == 0,
+              "DUPLICATE_FILTER_SLOTS must be a power of two");
+static_assert(DUPLICATE_FILTER_PROBE <= DUPLICATE_FILTER_SLOTS,
+              "DUPLICATE_FILTER_PROBE must not exceed the table");
+
+DuplicateFilter::DuplicateFilter()
+    : _suppressed(0) {
+    memset(_slots, 0, sizeof(_slots));
+}
+
+uint32_t DuplicateFilter::hash(uint32_t source, uint32_t id) {
+    // Packet ids are sequential per node; mix well before masking
+    uint32_t h = source * 0x9E3779B1u ^ id;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+bool DuplicateFilter::seen(uint32_t source, uint32_t id, uint32_t now) {
+    if (now == 0) now = 1;  // 0 marks an empty slot
+
+    uint32_t start = hash(source, id) & (DUPLICATE_FILTER_SLOTS - 1);
+    for (uint16_t i = 0; i < DUPLICATE_FILTER_PROBE; i++) {
+        Slot &s = _slots[(start + i) & (DUPLICATE_FILTER_SLOTS - 1)];
+        bool live = s.lastSeen != 0 && now - s.lastSeen <= DUPLICATE_WINDOW_MS;
+
+        if (live && s.source == source && s.id == id) {
+            s.lastSeen = now;
+            _suppressed++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DuplicateFilter::record(uint32_t source, uint32_t id, uint32_t now) {
+    if (now == 0) now = 1;
+
+    uint32_t start = hash(source, id) & (DUPLICATE_FILTER_SLOTS - 1);
+    Slot    *victim = NULL;
+    uint32_t victimAge = 0;
+
+    for (uint16_t i = 0; i < DUPLICATE_FILTER_PROBE; i++) {
+        Slot &s = _slots[(start + i) & (DUPLICATE_FILTER_SLOTS - 1)];
+        uint32_t age = now - s.lastSeen;
+        bool live = s.lastSeen != 0 && age <= DUPLICATE_WINDOW_MS;
+
+        if (live && s.source == source && s.id == id) {
+            s.lastSeen = now;
+            return;
+        }
+
+        // First free or aged-out slot, else the one seen longest ago
+        if (!live) age = 0xFFFFFFFF;
+        if (!victim || age > victimAge) {
+            victim = &s;
+            victimAge = age;
+        }
+    }
+
+    victim->source   = source;
+    victim->id       = id;
+    victim->lastSeen = now;
+}
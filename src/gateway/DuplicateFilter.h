@@ -0,0 +1,48 @@
+/**
+ * DuplicateFilter — Drops mesh rebroadcasts already queued for the satellite
+ * © Mikoshi Ltd. — Apache 2.0
+ */
+
+#ifndef DUPLICATE_FILTER_H
+#define DUPLICATE_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+/**
+ * Fixed-size seen-set of Meshtastic (source, packet id) pairs. Neighbours
+ * relaying the same packet reach the gateway several times; only the
+ * first copy within DUPLICATE_WINDOW_MS should use satellite airtime.
+ *
+ * Open addressing over DUPLICATE_FILTER_SLOTS with a bounded probe: a
+ * new key takes an empty or aged-out slot in its probe run, else evicts
+ * the least recently seen one. Lookups and inserts are O(probe).
+ *
+ * A packet is recorded only once it has been queued, so a copy that
+ * arrives after a failed translation or a full queue gets another chance.
+ */
+class DuplicateFilter {
+public:
+    DuplicateFilter();
+
+    // True if (source, id) was recorded within the window
+    bool seen(uint32_t source, uint32_t id, uint32_t now);
+    void record(uint32_t source, uint32_t id, uint32_t now);
+
+    uint32_t suppressed() const { return _suppressed; }
+
+private:
+    struct Slot {
+        uint32_t source;
+        uint32_t id;
+        uint32_t lastSeen;  // millis(); 0 = empty
+    };
+
+    Slot     _slots[DUPLICATE_FILTER_SLOTS];
+    uint32_t _suppressed;
+
+    static uint32_t hash(uint32_t source, uint32_t id);
+};
+
+#endif // DUPLICATE_FILTER_H
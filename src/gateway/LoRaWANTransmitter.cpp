@@ -78,18 +78,18 @@ bool LoRaWANTransmitter::join() {
     return true;
 }
 
-bool LoRaWANTransmitter::send(const uint8_t *payload, uint16_t len, uint8_t fport) {
-    if (!_initialized || !_joined) return false;
-    if (len > LORAWAN_MAX_PAYLOAD) return false;
+LoRaWANSendResult LoRaWANTransmitter::send(const uint8_t *payload, uint16_t len, uint8_t fport) {
+    if (!_initialized || !_joined) return LORAWAN_DEFERRED;
+    if (len > LORAWAN_MAX_PAYLOAD) return LORAWAN_DEFERRED;
 
     resetDutyCycleIfNeeded();
 
-    uint32_t airtime = estimateAirtimeMs(len);
+    uint32_t airtime = airtimeMs(len);
     if (!canTransmit(airtime)) {
         if (DEBUG_SERIAL) {
             Serial.println("[LoRaWAN] Duty cycle limit reached, deferring.");
         }
-        return false;
+        return LORAWAN_DEFERRED;
     }
 
     if (DEBUG_SERIAL) {
@@ -115,6 +115,7 @@ bool LoRaWANTransmitter::send(const uint8_t *payload, uint16_t len, uint8_t fpor
             memcpy(_downlink.payload, downBuf, downLen);
             _downlink.len = downLen;
             _downlink.fport = fport;
+            _downlink.snr = radio2.getSNR();
             _downlink.pending = true;
 
             if (DEBUG_SERIAL) {
@@ -122,14 +123,14 @@ bool LoRaWANTransmitter::send(const uint8_t *payload, uint16_t len, uint8_t fpor
             }
         }
 
-        return true;
+        return LORAWAN_SENT;
     }
 
     if (DEBUG_SERIAL) {
         Serial.print("[LoRaWAN] Send failed, code: ");
         Serial.println(state);
     }
-    return false;
+    return LORAWAN_FAILED;
 }
 
 bool LoRaWANTransmitter::canTransmit(uint32_t packetAirtimeMs) {
@@ -137,13 +138,28 @@ bool LoRaWANTransmitter::canTransmit(uint32_t packetAirtimeMs) {
     return (_airtimeUsedMs + packetAirtimeMs) <= DUTY_CYCLE_LIMIT_MS;
 }
 
+/**
+ * Largest application payload at the configured region and spreading
+ * factor (LoRaWAN Regional Parameters, no MAC commands in FOpts),
+ * capped at LORAWAN_MAX_PAYLOAD.
+ */
+uint16_t LoRaWANTransmitter::maxPayload() const {
+#if LORAWAN_REGION == LORAWAN_REGION_US915
+    uint16_t n = LORAWAN_SF >= 10 ? 11 : LORAWAN_SF == 9 ? 53 : LORAWAN_SF == 8 ? 125 : 242;
+#else
+    uint16_t n = LORAWAN_SF >= 10 ? 51 : LORAWAN_SF == 9 ? 115 : 222;
+#endif
+    return n < LORAWAN_MAX_PAYLOAD ? n : LORAWAN_MAX_PAYLOAD;
+}
+
 DownlinkMessage LoRaWANTransmitter::getDownlink() {
     DownlinkMessage msg = _downlink;
     _downlink.pending = false;
     return msg;
 }
 
-uint32_t LoRaWANTransmitter::getAirtimeRemainingMs() const {
+uint32_t LoRaWANTransmitter::getAirtimeRemainingMs() {
+    resetDutyCycleIfNeeded();
     if (_airtimeUsedMs >= DUTY_CYCLE_LIMIT_MS) return 0;
     return DUTY_CYCLE_LIMIT_MS - _airtimeUsedMs;
 }
@@ -159,15 +175,24 @@ void LoRaWANTransmitter::resetDutyCycleIfNeeded() {
     }
 }
 
-uint32_t LoRaWANTransmitter::estimateAirtimeMs(uint16_t payloadLen) {
-    // Simplified LoRa airtime estimation for SF9/125kHz
-    // Real calculation depends on SF, BW, CR, preamble, header mode
-    // This is a conservative estimate
-    float symbolTime = (1 << LORAWAN_SF) / 125.0f;  // ms per symbol
+/**
+ * Time on air of an uplink with payloadLen application bytes at the
+ * configured spreading factor (Semtech AN1200.13): 125 kHz, coding rate
+ * 4/5, 8-symbol preamble, explicit header, CRC on, low data rate
+ * optimisation at SF11-12. Counts the LoRaWAN MAC overhead.
+ */
+uint32_t LoRaWANTransmitter::airtimeMs(uint16_t payloadLen) const {
+    const int32_t sf = LORAWAN_SF;
+    const int32_t de = sf >= 11 ? 1 : 0;
+    const int32_t pl = payloadLen + LORAWAN_OVERHEAD;
+
+    float symbolTime = (float)(1 << sf) / 125.0f;  // ms per symbol
     float preambleTime = (8 + 4.25f) * symbolTime;
-    float payloadSymbols = 8 + ((8 * payloadLen - 4 * LORAWAN_SF + 28 + 16) /
-                                (4 * (LORAWAN_SF - 2))) * 5;
-    if (payloadSymbols < 8) payloadSymbols = 8;
-    float payloadTime = payloadSymbols * symbolTime;
-    return (uint32_t)(preambleTime + payloadTime + 0.5f);
+
+    int32_t bits = 8 * pl - 4 * sf + 28 + 16;
+    int32_t div  = 4 * (sf - 2 * de);
+    int32_t blocks = bits > 0 ? (bits + div - 1) / div : 0;
+    float payloadTime = (8 + blocks * 5) * symbolTime;
+
+    return (uint32_t)(preambleTime + payloadTime + 0.999f);
 }
@@ -10,15 +10,24 @@
 #include <stdbool.h>
 
 #define LORAWAN_MAX_PAYLOAD  128
+#define LORAWAN_OVERHEAD     13   // MHDR(1) + FHDR(7) + FPort(1) + MIC(4)
 #define DOWNLINK_BUFFER_SIZE 256
 
 struct DownlinkMessage {
     uint8_t  payload[DOWNLINK_BUFFER_SIZE];
     uint16_t len;
     uint8_t  fport;
+    float    snr;           // dB, as measured on the downlink
     bool     pending;
 };
 
+// Outcome of send()
+enum LoRaWANSendResult {
+    LORAWAN_SENT,
+    LORAWAN_DEFERRED,   // Not attempted: not joined, too long or no duty cycle left
+    LORAWAN_FAILED,     // Attempted; the radio or the stack reported an error
+};
+
 class LoRaWANTransmitter {
 public:
     LoRaWANTransmitter();
@@ -27,14 +36,17 @@ public:
     bool join();
     bool isJoined() const { return _joined; }
 
-    bool send(const uint8_t *payload, uint16_t len, uint8_t fport);
+    LoRaWANSendResult send(const uint8_t *payload, uint16_t len, uint8_t fport);
     bool canTransmit(uint32_t packetAirtimeMs);
 
     bool hasDownlink() const { return _downlink.pending; }
     DownlinkMessage getDownlink();
 
+    uint16_t maxPayload() const;
+    uint32_t airtimeMs(uint16_t payloadLen) const;
+
     uint32_t getAirtimeUsedMs() const { return _airtimeUsedMs; }
-    uint32_t getAirtimeRemainingMs() const;
+    uint32_t getAirtimeRemainingMs();   // Starts a new duty-cycle window when due
 
 private:
     bool     _initialized;
@@ -44,7 +56,6 @@ private:
     DownlinkMessage _downlink;
 
     void     resetDutyCycleIfNeeded();
-    uint32_t estimateAirtimeMs(uint16_t payloadLen);
 };
 
 #endif // LORAWAN_TRANSMITTER_H
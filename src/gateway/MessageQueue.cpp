@@ -0,0 +1,256 @@
+/**
+ * MessageQueue — Store & forward queue: fixed entry pool, FIFO per priority
+ * © Mikoshi Ltd. — Apache 2.0
+ */
+
+#include "MessageQueue.h"
+#include <string.h>
+
+static_assert(QUEUE_MAX_ENTRIES > 0 && QUEUE_MAX_ENTRIES < QUEUE_NONE,
+              "QUEUE_MAX_ENTRIES must fit a 16-bit index");
+static_assert(QUEUE_ARENA_BYTES >= QUEUE_ARENA_HEADER + MAX_SATELLITE_PAYLOAD &&
+              QUEUE_ARENA_BYTES <= 0xFFFF,
+              "QUEUE_ARENA_BYTES must hold one full payload and fit a 16-bit offset");
+
+MessageQueue::MessageQueue()
+    : _free(0)
+    , _count(0)
+    , _heapCount(0)
+    , _arenaTop(0)
+    , _arenaLive(0) {
+    for (uint16_t i = 0; i < QUEUE_MAX_ENTRIES; i++) {
+        _pool[i].next = i + 1 < QUEUE_MAX_ENTRIES ? i + 1 : QUEUE_NONE;
+    }
+    for (uint8_t p = 0; p <= PRIORITY_LOW; p++) {
+        _head[p] = QUEUE_NONE;
+    }
+}
+
+static inline void putBlock(uint8_t *p, uint16_t owner, uint16_t len) {
+    p[0] = owner >> 8;
+    p[1] = owner & 0xFF;
+    p[2] = len >> 8;
+    p[3] = len & 0xFF;
+}
+
+/**
+ * Free slot with payloadLen bytes of arena, not yet queued. NULL if the
+ * pool or the arena is exhausted.
+ */
+QueueEntry *MessageQueue::alloc(uint16_t payloadLen) {
+    uint32_t need = (uint32_t)QUEUE_ARENA_HEADER + payloadLen;
+    if (_free == QUEUE_NONE || need > (uint32_t)(QUEUE_ARENA_BYTES - _arenaLive)) return NULL;
+    if (need > (uint32_t)(QUEUE_ARENA_BYTES - _arenaTop)) compact();
+
+    uint16_t i = _free;
+    QueueEntry *entry = &_pool[i];
+    _free = entry->next;
+    entry->prev = QUEUE_NONE;
+    entry->next = QUEUE_NONE;
+    _count++;
+
+    putBlock(_arena + _arenaTop, i, payloadLen);
+    entry->payloadOff = (uint16_t)(_arenaTop + QUEUE_ARENA_HEADER);
+    entry->payloadLen = payloadLen;
+    _arenaTop  += (uint16_t)need;
+    _arenaLive += (uint16_t)need;
+    return entry;
+}
+
+/**
+ * Return an unqueued (allocated or popped) entry and its payload.
+ */
+void MessageQueue::release(QueueEntry *entry) {
+    uint16_t block = (uint16_t)(entry->payloadOff - QUEUE_ARENA_HEADER);
+    putBlock(_arena + block, QUEUE_NONE, entry->payloadLen);
+    _arenaLive -= (uint16_t)(QUEUE_ARENA_HEADER + entry->payloadLen);
+    if (block + QUEUE_ARENA_HEADER + entry->payloadLen == _arenaTop) {
+        _arenaTop = block;  // Last block: reclaim at once
+    }
+
+    entry->next = _free;
+    _free = indexOf(entry);
+    _count--;
+}
+
+/**
+ * Slide live blocks down over freed ones, in address order, and point
+ * their entries at the new offsets. O(arena); run between passes.
+ */
+void MessageQueue::compact() {
+    uint16_t src = 0;
+    uint16_t dst = 0;
+
+    while (src < _arenaTop) {
+        uint16_t owner = (uint16_t)((_arena[src] << 8) | _arena[src + 1]);
+        uint16_t len   = (uint16_t)((_arena[src + 2] << 8) | _arena[src + 3]);
+        uint16_t size  = (uint16_t)(QUEUE_ARENA_HEADER + len);
+
+        if (owner != QUEUE_NONE) {
+            if (dst != src) memmove(_arena + dst, _arena + src, size);
+            _pool[owner].payloadOff = (uint16_t)(dst + QUEUE_ARENA_HEADER);
+            dst += size;
+        }
+        src += size;
+    }
+    _arenaTop = dst;
+}
+
+// Out-of-range priorities queue with the lowest
+uint8_t MessageQueue::level(const QueueEntry *entry) const {
+    return entry->priority > PRIORITY_LOW ? PRIORITY_LOW : entry->priority;
+}
+
+void MessageQueue::push(QueueEntry *entry) {
+    uint16_t i = indexOf(entry);
+    uint16_t &head = _head[level(entry)];
+
+    heapInsert(i);
+
+    if (head == QUEUE_NONE) {
+        entry->prev = i;
+        entry->next = i;
+        head = i;
+        return;
+    }
+
+    uint16_t tail = _pool[head].prev;
+    entry->prev = tail;
+    entry->next = head;
+    _pool[tail].next = i;
+    _pool[head].prev = i;
+}
+
+/**
+ * Queue ahead of everything else of the same priority, so a retried
+ * entry keeps its place.
+ */
+void MessageQueue::pushFront(QueueEntry *entry) {
+    push(entry);
+    _head[level(entry)] = indexOf(entry);
+}
+
+/**
+ * Unlink the oldest entry of the highest non-empty priority. The slot
+ * stays allocated until released or pushed back.
+ */
+QueueEntry *MessageQueue::pop() {
+    for (uint8_t p = 0; p <= PRIORITY_LOW; p++) {
+        if (_head[p] == QUEUE_NONE) continue;
+
+        QueueEntry *entry = &_pool[_head[p]];
+        unlink(entry);
+        return entry;
+    }
+    return NULL;
+}
+
+/**
+ * Unlink a queued entry chosen by the caller, keeping its slot as pop()
+ * does.
+ */
+void MessageQueue::take(QueueEntry *entry) {
+    unlink(entry);
+}
+
+/**
+ * Unlink a queued entry and free its slot.
+ */
+void MessageQueue::remove(QueueEntry *entry) {
+    unlink(entry);
+    release(entry);
+}
+
+/**
+ * Unlink the queued entry that expires first if it is due at now
+ * (seconds, same clock as expires), else NULL. The caller releases it;
+ * call until NULL to expire everything due.
+ */
+QueueEntry *MessageQueue::popExpired(uint32_t now) {
+    if (_heapCount == 0) return NULL;
+
+    QueueEntry *entry = &_pool[_heap[0]];
+    if (entry->expires > now) return NULL;
+    unlink(entry);
+    return entry;
+}
+
+QueueEntry *MessageQueue::first(uint8_t priority) {
+    if (priority > PRIORITY_LOW || _head[priority] == QUEUE_NONE) return NULL;
+    return &_pool[_head[priority]];
+}
+
+QueueEntry *MessageQueue::next(const QueueEntry *entry) {
+    if (entry->next == _head[level(entry)]) return NULL;
+    return &_pool[entry->next];
+}
+
+void MessageQueue::unlink(QueueEntry *entry) {
+    uint16_t i = indexOf(entry);
+    uint16_t &head = _head[level(entry)];
+
+    heapRemove(entry->heapPos);
+
+    if (entry->next == i) {
+        head = QUEUE_NONE;
+    } else {
+        _pool[entry->prev].next = entry->next;
+        _pool[entry->next].prev = entry->prev;
+        if (head == i) head = entry->next;
+    }
+    entry->prev = QUEUE_NONE;
+    entry->next = QUEUE_NONE;
+}
+
+// ------------------------------------------------------------
+// Expiry heap
+// ------------------------------------------------------------
+
+void MessageQueue::heapSet(uint16_t pos, uint16_t index) {
+    _heap[pos] = index;
+    _pool[index].heapPos = pos;
+}
+
+void MessageQueue::heapInsert(uint16_t index) {
+    heapSet(_heapCount, index);
+    heapUp(_heapCount++);
+}
+
+void MessageQueue::heapRemove(uint16_t pos) {
+    uint16_t last = _heap[--_heapCount];
+    if (pos == _heapCount) return;
+
+    // Move the last entry into the hole, then restore order either way
+    heapSet(pos, last);
+    heapUp(pos);
+    heapDown(_pool[last].heapPos);
+}
+
+void MessageQueue::heapUp(uint16_t pos) {
+    uint16_t index = _heap[pos];
+    uint32_t key = _pool[index].expires;
+
+    while (pos > 0) {
+        uint16_t parent = (uint16_t)((pos - 1) / 2);
+        if (_pool[_heap[parent]].expires <= key) break;
+        heapSet(pos, _heap[parent]);
+        pos = parent;
+    }
+    heapSet(pos, index);
+}
+
+void MessageQueue::heapDown(uint16_t pos) {
+    uint16_t index = _heap[pos];
+    uint32_t key = _pool[index].expires;
+
+    for (;;) {
+        uint32_t child = 2 * (uint32_t)pos + 1;
+        if (child >= _heapCount) break;
+        if (child + 1 < _heapCount &&
+            _pool[_heap[child + 1]].expires < _pool[_heap[child]].expires) child++;
+        if (key <= _pool[_heap[child]].expires) break;
+        heapSet(pos, _heap[child]);
+        pos = (uint16_t)child;
+    }
+    heapSet(pos, index);
+}
@@ -0,0 +1,102 @@
+/**
+ * MessageQueue — Store & forward queue: fixed entry pool, FIFO per priority
+ * © Mikoshi Ltd. — Apache 2.0
+ */
+
+#ifndef MESSAGE_QUEUE_H
+#define MESSAGE_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "PacketTranslator.h"
+#include "config.h"
+
+#define QUEUE_NONE          0xFFFF  // No entry (list end, empty list)
+#define QUEUE_ARENA_HEADER  4       // Arena bytes per payload besides the payload
+
+struct QueueEntry {
+    uint32_t id;
+    uint32_t expires;       // Absolute expiry, s (wrap-free clock)
+    uint32_t storeKey;      // Record key in the persistent log (QueueStore)
+    uint16_t payloadLen;
+    uint16_t payloadOff;    // Payload offset in the queue's arena
+
+    // Pool links: neighbours in the priority list, or the free list
+    uint16_t prev;
+    uint16_t next;
+    uint16_t heapPos;       // Position in the expiry heap
+
+    uint8_t  priority : 4;
+    uint8_t  retries  : 4;
+};
+
+/**
+ * Entries live in a fixed pool and are never moved; their payloads live
+ * in a byte arena sized for typical frames rather than the largest one.
+ * Each priority level
+ * is a doubly linked ring of pool indices, so enqueue, dequeue and
+ * removal from the middle (containers, expiry) are O(1) at any depth.
+ *
+ * An entry is allocated, filled, then pushed. pop() unlinks the next
+ * entry to send but keeps its slot: the caller releases it once sent or
+ * pushes it back to the front of its priority to retry. take() does the
+ * same for an entry the caller picked itself.
+ *
+ * Queued entries are also kept in a binary min-heap on their absolute
+ * expiry, so expiring pops only the entries that are due.
+ *
+ * Arena blocks are a 4-byte header (owner slot, length) and the payload,
+ * bump-allocated. Freed blocks are reclaimed by compact(), which slides
+ * live blocks down in one pass; alloc() compacts on its own only when the
+ * free bytes exist but not at the top. Payload pointers are valid until
+ * the next alloc() or compact().
+ */
+class MessageQueue {
+public:
+    MessageQueue();
+
+    uint16_t count() const { return _count; }
+    bool     full() const { return _free == QUEUE_NONE; }
+    uint16_t arenaFree() const { return (uint16_t)(QUEUE_ARENA_BYTES - _arenaLive); }
+
+    QueueEntry *alloc(uint16_t payloadLen);
+    void        release(QueueEntry *entry);
+    uint8_t    *payload(const QueueEntry *entry) { return _arena + entry->payloadOff; }
+    void        compact();
+
+    void        push(QueueEntry *entry);
+    void        pushFront(QueueEntry *entry);
+    QueueEntry *pop();
+    void        take(QueueEntry *entry);
+    void        remove(QueueEntry *entry);
+    QueueEntry *popExpired(uint32_t now);
+
+    // Queued entries of one priority, oldest first
+    QueueEntry *first(uint8_t priority);
+    QueueEntry *next(const QueueEntry *entry);
+
+private:
+    QueueEntry _pool[QUEUE_MAX_ENTRIES];
+    uint16_t   _head[PRIORITY_LOW + 1];
+    uint16_t   _free;
+    uint16_t   _count;       // Allocated entries, queued or popped
+
+    uint16_t   _heap[QUEUE_MAX_ENTRIES];    // Pool indices, earliest expiry first
+    uint16_t   _heapCount;
+
+    uint8_t    _arena[QUEUE_ARENA_BYTES];
+    uint16_t   _arenaTop;    // End of the last block
+    uint16_t   _arenaLive;   // Bytes in live blocks, headers included
+
+    uint16_t indexOf(const QueueEntry *entry) const { return (uint16_t)(entry - _pool); }
+    uint8_t  level(const QueueEntry *entry) const;
+    void     unlink(QueueEntry *entry);
+
+    void     heapInsert(uint16_t index);
+    void     heapRemove(uint16_t pos);
+    void     heapUp(uint16_t pos);
+    void     heapDown(uint16_t pos);
+    void     heapSet(uint16_t pos, uint16_t index);
+};
+
+#endif // MESSAGE_QUEUE_H
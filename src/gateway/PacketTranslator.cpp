@@ -7,10 +7,25 @@
 #include "config.h"
 #include "../meshxt/MeshXTCompress.h"
 #include "../meshxt/MeshXTFEC.h"
+#include "../meshxt/MeshXTPacket.h"
 #include <Arduino.h>
 #include <string.h>
 
-PacketTranslator::PacketTranslator() {}
+PacketTranslator::PacketTranslator()
+    : _uplinkHistory(0)
+    , _uplinkSamples(0)
+    , _snrAvg(0.0f)
+    , _haveSnr(false)
+    , _fecErrorsAvg(0.0f)
+    , _haveFecErrors(false)
+    , _txNodesSeeded(false)
+    , _nextFragmentId(0) {
+    memset(_txNodes, 0, sizeof(_txNodes));
+    memset(_rxNodes, 0, sizeof(_rxNodes));
+    memset(_held, 0, sizeof(_held));
+    memset(_reassembly, 0, sizeof(_reassembly));
+    memset(_posTracks, 0, sizeof(_posTracks));
+}
 
 bool PacketTranslator::toSatellite(const MeshtasticPacket &meshPkt, SatellitePacket &satPkt) {
     satPkt.version    = RELAY_VERSION;
@@ -19,6 +34,9 @@ bool PacketTranslator::toSatellite(const MeshtasticPacket &meshPkt, SatellitePac
     satPkt.channel    = 0;  // Default channel; could extract from Meshtastic header
     satPkt.timestamp  = (uint32_t)(millis() / 1000);  // Relative timestamp
     satPkt.priority   = determinePriority(meshPkt);
+    satPkt.type       = satPkt.priority == PRIORITY_EMERGENCY ? RELAY_TYPE_SOS
+                      : meshPkt.portnum == PORTNUM_POSITION_APP ? RELAY_TYPE_POS
+                      : RELAY_TYPE_TEXT;
 
     if (meshPkt.isMeshXT) {
         // Already compressed — pass through the MeshXT payload directly
@@ -29,10 +47,17 @@ bool PacketTranslator::toSatellite(const MeshtasticPacket &meshPkt, SatellitePac
         if (DEBUG_SERIAL) {
             Serial.printf("[Translator] MeshXT passthrough: %d bytes\n", satPkt.payloadLen);
         }
+    } else if (POSITION_ENABLED && meshPkt.portnum == PORTNUM_POSITION_APP &&
+               encodePosition(meshPkt, satPkt)) {
+        if (DEBUG_SERIAL) {
+            Serial.printf("[Translator] Position %d -> %d bytes\n",
+                meshPkt.payloadLen, satPkt.payloadLen);
+        }
     } else {
         // Plain text — compress with MeshXT for satellite
         if (!compressPayload(meshPkt.payload, meshPkt.payloadLen,
-                             satPkt.payload, satPkt.payloadLen)) {
+                             satPkt.payload, satPkt.payloadLen,
+                             sizeof(satPkt.payload), satPkt.priority)) {
             // Compression failed — send raw (may be too large)
             if (meshPkt.payloadLen > sizeof(satPkt.payload)) return false;
             memcpy(satPkt.payload, meshPkt.payload, meshPkt.payloadLen);
@@ -54,13 +79,15 @@ bool PacketTranslator::toSatellite(const MeshtasticPacket &meshPkt, SatellitePac
 }
 
 bool PacketTranslator::serialize(const SatellitePacket &satPkt, uint8_t *out, uint16_t &outLen) {
+    if (satPkt.version == RELAY_VERSION_2 && serializeV2(satPkt, out, outLen)) return true;
+
     uint16_t totalLen = RELAY_HEADER_SIZE + satPkt.payloadLen;
-    if (totalLen > MAX_SATELLITE_PAYLOAD) return false;
+    if (totalLen > MAX_RELAY_FRAME) return false;
 
     uint16_t idx = 0;
 
     // Version
-    out[idx++] = satPkt.version;
+    out[idx++] = RELAY_VERSION_1;
 
     // Source node (big-endian)
     out[idx++] = (satPkt.sourceNode >> 24) & 0xFF;
@@ -92,18 +119,38 @@ bool PacketTranslator::serialize(const SatellitePacket &satPkt, uint8_t *out, ui
 }
 
 bool PacketTranslator::fromSatellite(const uint8_t *data, uint16_t len, SatellitePacket &satPkt) {
-    if (len < RELAY_HEADER_SIZE) return false;
+    if (len < 1) return false;
 
-    uint16_t idx = 0;
+    if ((data[0] >> 4) == RELAY_VERSION_2) {
+        if (!parseV2(data, len, satPkt)) return false;
+    } else if (data[0] == RELAY_VERSION_1) {
+        if (!parseV1(data, len, satPkt)) return false;
+    } else {
+        if (DEBUG_SERIAL) {
+            Serial.printf("[Translator] Unknown relay version: %d\n", data[0]);
+        }
+        return false;
+    }
 
-    satPkt.version = data[idx++];
-    if (satPkt.version != RELAY_VERSION) {
+    // Correct and strip RS parity so the mesh gets a plain MeshXT payload
+    if (!stripFec(satPkt.payload, satPkt.payloadLen)) {
         if (DEBUG_SERIAL) {
-            Serial.printf("[Translator] Unknown relay version: %d\n", satPkt.version);
+            Serial.println("[Translator] Downlink FEC uncorrectable.");
         }
         return false;
     }
 
+    return true;
+}
+
+bool PacketTranslator::parseV1(const uint8_t *data, uint16_t len, SatellitePacket &satPkt) {
+    if (len < RELAY_HEADER_SIZE) return false;
+
+    uint16_t idx = 0;
+
+    satPkt.version = data[idx++];
+    satPkt.type    = RELAY_TYPE_TEXT;  // v1 has no type field
+
     satPkt.sourceNode = ((uint32_t)data[idx] << 24) | ((uint32_t)data[idx+1] << 16) |
                         ((uint32_t)data[idx+2] << 8) | data[idx+3];
     idx += 4;
@@ -121,12 +168,136 @@ bool PacketTranslator::fromSatellite(const uint8_t *data, uint16_t len, Satellit
     satPkt.payloadLen = len - idx;
     if (satPkt.payloadLen > sizeof(satPkt.payload)) return false;
     memcpy(satPkt.payload, data + idx, satPkt.payloadLen);
+    return true;
+}
+
+static_assert(RELAY_NODE_SLOTS <= 1024, "v2 sender index must fit two varint bytes");
+
+/**
+ * v2 header: [VVVV TTTT], varint (node index << 4 | generation << 2 |
+ * flags), [sender ID], [destination], channel, 16-bit minutes. Falls back
+ * to v1 (false) for a node the table cannot index.
+ */
+bool PacketTranslator::serializeV2(const SatellitePacket &satPkt, uint8_t *out, uint16_t &outLen) {
+    if (!_txNodesSeeded) {
+        // Seeded on first use rather than at construction, when the
+        // clock does not yet differ between boots
+#if defined(ESP32)
+        meshxt_node_reset(_txNodes, RELAY_NODE_SLOTS, esp_random());
+#else
+        meshxt_node_reset(_txNodes, RELAY_NODE_SLOTS, micros());
+#endif
+        _txNodesSeeded = true;
+    }
+
+    bool    withId;
+    uint8_t gen;
+    int index = meshxt_node_index(_txNodes, RELAY_NODE_SLOTS, satPkt.sourceNode, millis(),
+                                  RELAY_NODE_ANNOUNCE, RELAY_NODE_REANNOUNCE, &withId, &gen);
+    if (index < 0) return false;
+
+    bool broadcast = satPkt.destNode == 0xFFFFFFFF;
+    uint32_t sender = ((uint32_t)index << 4) | ((uint32_t)gen << 2) |
+                      (withId ? RELAY_V2_NODE_ID : 0) | (broadcast ? 0 : RELAY_V2_DEST);
+
+    uint8_t  hdr[RELAY_HEADER_SIZE];
+    uint16_t idx = 0;
+
+    hdr[idx++] = (uint8_t)((RELAY_VERSION_2 << 4) | (satPkt.type & 0x0F));
 
+    do {
+        uint8_t b = sender & 0x7F;
+        sender >>= 7;
+        hdr[idx++] = sender ? (uint8_t)(b | 0x80) : b;
+    } while (sender);
+
+    if (withId) {
+        hdr[idx++] = (satPkt.sourceNode >> 24) & 0xFF;
+        hdr[idx++] = (satPkt.sourceNode >> 16) & 0xFF;
+        hdr[idx++] = (satPkt.sourceNode >> 8)  & 0xFF;
+        hdr[idx++] = satPkt.sourceNode & 0xFF;
+    }
+    if (!broadcast) {
+        hdr[idx++] = (satPkt.destNode >> 24) & 0xFF;
+        hdr[idx++] = (satPkt.destNode >> 16) & 0xFF;
+        hdr[idx++] = (satPkt.destNode >> 8)  & 0xFF;
+        hdr[idx++] = satPkt.destNode & 0xFF;
+    }
+
+    hdr[idx++] = satPkt.channel;
+
+    // Minutes of the gateway clock, wrapping every ~45 days
+    uint16_t minutes = (uint16_t)(satPkt.timestamp / 60);
+    hdr[idx++] = (minutes >> 8) & 0xFF;
+    hdr[idx++] = minutes & 0xFF;
+
+    if (idx + satPkt.payloadLen > MAX_RELAY_FRAME) return false;
+    memcpy(out, hdr, idx);
+    memcpy(out + idx, satPkt.payload, satPkt.payloadLen);
+    outLen = idx + satPkt.payloadLen;
+    return true;
+}
+
+bool PacketTranslator::parseV2(const uint8_t *data, uint16_t len, SatellitePacket &satPkt) {
+    uint16_t idx = 0;
+
+    satPkt.version = data[idx] >> 4;
+    satPkt.type    = data[idx] & 0x0F;
+    idx++;
+
+    // Sender field: at most 3 varint bytes
+    uint32_t sender = 0;
+    for (uint8_t shift = 0;; shift += 7) {
+        if (idx >= len || shift > 14) return false;
+        uint8_t b = data[idx++];
+        sender |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+    }
+    uint16_t index = (uint16_t)(sender >> 4);
+    uint8_t  gen   = (uint8_t)((sender >> 2) & MESHXT_NODE_GEN_MASK);
+
+    if (sender & RELAY_V2_NODE_ID) {
+        if (len - idx < 4) return false;
+        satPkt.sourceNode = ((uint32_t)data[idx] << 24) | ((uint32_t)data[idx+1] << 16) |
+                            ((uint32_t)data[idx+2] << 8) | data[idx+3];
+        idx += 4;
+        meshxt_node_bind(_rxNodes, RELAY_NODE_SLOTS, index, satPkt.sourceNode, gen);
+    } else {
+        // Unbound, or bound in another generation: dropped, never guessed
+        satPkt.sourceNode = meshxt_node_resolve(_rxNodes, RELAY_NODE_SLOTS, index, gen);
+        if (satPkt.sourceNode == 0) {
+            if (DEBUG_SERIAL) {
+                Serial.printf("[Translator] Unknown sender index %d (generation %d)\n",
+                    index, gen);
+            }
+            return false;
+        }
+    }
+
+    if (sender & RELAY_V2_DEST) {
+        if (len - idx < 4) return false;
+        satPkt.destNode = ((uint32_t)data[idx] << 24) | ((uint32_t)data[idx+1] << 16) |
+                          ((uint32_t)data[idx+2] << 8) | data[idx+3];
+        idx += 4;
+    } else {
+        satPkt.destNode = 0xFFFFFFFF;
+    }
+
+    if (len - idx < 3) return false;
+    satPkt.channel   = data[idx++];
+    satPkt.timestamp = (((uint32_t)data[idx] << 8) | data[idx+1]) * 60;
+    idx += 2;
+
+    satPkt.payloadLen = len - idx;
+    if (satPkt.payloadLen > sizeof(satPkt.payload)) return false;
+    memcpy(satPkt.payload, data + idx, satPkt.payloadLen);
     return true;
 }
 
 bool PacketTranslator::toMeshtastic(const SatellitePacket &satPkt, uint8_t *out, uint16_t &outLen) {
     // Reconstruct a Meshtastic-compatible packet for mesh injection
+    // (14-byte header + payload, into a MESHTASTIC_MAX_PACKET buffer)
+    if (14 + satPkt.payloadLen > MESHTASTIC_MAX_PACKET) return false;
     uint16_t idx = 0;
 
     // Dest (big-endian)
@@ -186,56 +357,330 @@ uint8_t PacketTranslator::determinePriority(const MeshtasticPacket &pkt) {
 }
 
 bool PacketTranslator::compressPayload(const uint8_t *in, uint16_t inLen,
-                                        uint8_t *out, uint16_t &outLen) {
+                                        uint8_t *out, uint16_t &outLen,
+                                        uint16_t maxLen, uint8_t priority) {
 #if MESHXT_COMPRESSION_ENABLED
+    // Output never exceeds inLen + header; compress off to the side since
+    // out holds only maxLen
+    if (inLen > MESHTASTIC_MAX_PACKET) return false;
+    uint8_t compBuf[MESHTASTIC_MAX_PACKET + MESHXT_COMPRESS_HEADER_SIZE];
+    uint16_t compLen;
     MeshXTCompress compressor;
-    int result = compressor.compress(in, inLen, out, outLen);
-    if (result < 0) return false;
+    int result = compressor.compress(in, inLen, compBuf, compLen);
+    if (result < 0 || compLen > maxLen) return false;
+
+    memcpy(out, compBuf, compLen);
+    outLen = compLen;
 
 #if MESHXT_FEC_ENABLED
     // Add FEC parity
-    uint8_t fecBuf[MAX_SATELLITE_PAYLOAD];
-    uint16_t fecLen;
-    MeshXTFEC fec;
-    if (fec.encode(out, outLen, fecBuf, fecLen, MESHXT_FEC_REDUNDANCY)) {
-        memcpy(out, fecBuf, fecLen);
-        outLen = fecLen;
-    }
+    applyFec(out, outLen, maxLen, fecLevel(priority));
+#else
+    (void)priority;
 #endif
 
     return true;
 #else
     // No compression — just copy
+    (void)priority;
+    if (inLen > maxLen) return false;
     memcpy(out, in, inLen);
     outLen = inLen;
     return true;
 #endif
 }
 
+/**
+ * Code a Position protobuf as a MESHXT_MODE_POSITION frame against the
+ * node's previous report. False if it does not parse (the caller then
+ * sends it through generic compression).
+ */
+bool PacketTranslator::encodePosition(const MeshtasticPacket &meshPkt, SatellitePacket &satPkt) {
+    MeshXTPosition pos;
+    if (meshxt_position_parse(meshPkt.payload, meshPkt.payloadLen, &pos) < 0) return false;
+
+    // State advances here, at ingest: if this frame is later dropped the
+    // ground sees a sequence gap and waits for the node's next keyframe
+    MeshXTPositionTrack *track = meshxt_position_track(_posTracks, POSITION_TRACK_NODES,
+                                                       meshPkt.source, millis());
+    const MeshXTPositionQuant quant = { POSITION_STEP_LATLON, POSITION_STEP_ALT,
+                                        POSITION_STEP_TIME };
+    int n = meshxt_position_encode(track, &pos, &quant, POSITION_KEYFRAME_EVERY,
+                                   satPkt.payload + MESHXT_COMPRESS_HEADER_SIZE,
+                                   sizeof(satPkt.payload) - MESHXT_COMPRESS_HEADER_SIZE);
+    if (n < 0) return false;
+
+    satPkt.payload[0] = MESHXT_MAGIC_0;
+    satPkt.payload[1] = MESHXT_MAGIC_1;
+    satPkt.payload[2] = MESHXT_CTRL(MESHXT_MODE_POSITION);
+    satPkt.payloadLen = MESHXT_COMPRESS_HEADER_SIZE + n;
+
+#if MESHXT_FEC_ENABLED
+    applyFec(satPkt.payload, satPkt.payloadLen, sizeof(satPkt.payload), fecLevel(satPkt.priority));
+#endif
+    return true;
+}
+
+// RS parity level for a frame of this priority
+uint8_t PacketTranslator::fecLevel(uint8_t priority) const {
+#if MESHXT_FEC_ADAPTIVE
+    return fecLevelFor(priority);
+#else
+    (void)priority;
+    return MESHXT_FEC_REDUNDANCY == 64 ? MESHXT_FEC_HIGH_CODE
+         : MESHXT_FEC_REDUNDANCY == 32 ? MESHXT_FEC_MEDIUM_CODE
+         : MESHXT_FEC_LOW_CODE;
+#endif
+}
+
 bool PacketTranslator::decompressPayload(const uint8_t *in, uint16_t inLen,
-                                          uint8_t *out, uint16_t &outLen) {
+                                          uint8_t *out, uint16_t &outLen, uint16_t maxLen) {
 #if MESHXT_COMPRESSION_ENABLED
-    const uint8_t *dataIn = in;
-    uint16_t dataLen = inLen;
+    uint8_t frame[MAX_RELAY_FRAME];
+    if (inLen > sizeof(frame)) return false;
+    memcpy(frame, in, inLen);
+    uint16_t frameLen = inLen;
 
-#if MESHXT_FEC_ENABLED
     // Strip and verify FEC
-    uint8_t corrected[MAX_SATELLITE_PAYLOAD];
-    uint16_t correctedLen;
-    MeshXTFEC fec;
-    if (fec.decode(in, inLen, corrected, correctedLen)) {
-        dataIn = corrected;
-        dataLen = correctedLen;
-    }
-    // If FEC decode fails, try decompressing raw data anyway
-#endif
+    if (!stripFec(frame, frameLen)) return false;
 
     MeshXTCompress compressor;
-    int result = compressor.decompress(dataIn, dataLen, out, outLen);
+    int result = compressor.decompress(frame, frameLen, out, maxLen, outLen);
     return (result >= 0);
 #else
+    if (inLen > maxLen) return false;
     memcpy(out, in, inLen);
     outLen = inLen;
     return true;
 #endif
 }
+
+// ------------------------------------------------------------
+// Fragmentation
+// ------------------------------------------------------------
+
+static_assert(MAX_RELAY_FRAME <= MESHXT_REASSEMBLY_MAX, "reassembly slots must hold a relay frame");
+
+/**
+ * Keep a copy of a frame too large for one uplink so its fragments can
+ * be built now and rebuilt when the ground reports some missing. Takes a
+ * free slot, else the oldest.
+ */
+bool PacketTranslator::holdFragments(const uint8_t *frame, uint16_t len, uint16_t maxFragment,
+                                     uint8_t priority, uint32_t entryId, uint8_t &msgId,
+                                     uint8_t &count) {
+    int n = meshxt_fragment_count(len, maxFragment);
+    if (n < 0 || len > MAX_RELAY_FRAME) return false;
+
+    HeldFrame *slot = &_held[0];
+    for (uint8_t i = 0; i < FRAGMENT_TX_SLOTS; i++) {
+        if (!_held[i].active) {
+            slot = &_held[i];
+            break;
+        }
+        if ((int32_t)(_held[i].heldAt - slot->heldAt) < 0) slot = &_held[i];
+    }
+
+    slot->active      = true;
+    slot->id          = _nextFragmentId++;
+    slot->priority    = priority;
+    slot->entryId     = entryId;
+    slot->maxFragment = maxFragment;
+    slot->len         = len;
+    slot->heldAt      = millis();
+    memcpy(slot->frame, frame, len);
+
+    msgId = slot->id;
+    count = (uint8_t)n;
+    return true;
+}
+
+bool PacketTranslator::buildFragment(uint8_t msgId, uint8_t index, uint8_t *out, uint16_t &outLen,
+                                     uint8_t &priority) {
+    for (uint8_t i = 0; i < FRAGMENT_TX_SLOTS; i++) {
+        HeldFrame &h = _held[i];
+        if (!h.active || h.id != msgId) continue;
+
+        int n = meshxt_fragment_build(h.frame, h.len, h.id, index, h.maxFragment, out);
+        if (n < 0) return false;
+        outLen   = (uint16_t)n;
+        priority = h.priority;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Read a fragment status downlink. A complete message releases its held
+ * frame; otherwise missing names the fragments to send again, and
+ * entryId is the queue id they were first sent under.
+ *
+ * @return false if data is not a status or the message is no longer held
+ */
+bool PacketTranslator::fragmentStatus(const uint8_t *data, uint16_t len, uint8_t &msgId,
+                                      uint16_t &missing, uint32_t &entryId) {
+    if (meshxt_fragment_parse_status(data, len, &msgId, &missing) < 0) return false;
+
+    for (uint8_t i = 0; i < FRAGMENT_TX_SLOTS; i++) {
+        HeldFrame &h = _held[i];
+        if (!h.active || h.id != msgId) continue;
+        if (missing == 0) h.active = false;
+        entryId = h.entryId;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Add a downlink fragment.
+ *
+ * @return  1 with the relay frame in out once complete, 0 if more
+ *          fragments are needed, -1 if malformed
+ */
+int PacketTranslator::reassemble(const uint8_t *data, uint16_t len, uint8_t *out, uint16_t &outLen) {
+    MeshXTReassembly *slot;
+    int rc = meshxt_reassembly_add(_reassembly, FRAGMENT_RX_SLOTS, data, len, millis(), &slot);
+    if (rc <= 0) return rc;
+
+    bool fits = slot->len <= MAX_RELAY_FRAME;
+    if (fits) {
+        memcpy(out, slot->frame, slot->len);
+        outLen = slot->len;
+    }
+    meshxt_reassembly_release(slot);
+    return fits ? 1 : -1;
+}
+
+void PacketTranslator::expireFragments() {
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < FRAGMENT_TX_SLOTS; i++) {
+        if (_held[i].active && now - _held[i].heldAt > FRAGMENT_TX_HOLD_MS) {
+            _held[i].active = false;
+        }
+    }
+    size_t dropped = meshxt_reassembly_expire(_reassembly, FRAGMENT_RX_SLOTS, now,
+                                              FRAGMENT_RX_TIMEOUT_MS);
+    if (dropped && DEBUG_SERIAL) {
+        Serial.printf("[Translator] Dropped %d incomplete downlink messages\n", (int)dropped);
+    }
+}
+
+/**
+ * RS-encode the bytes after the MX header in place and record the level
+ * in the control byte. Steps the level down until the frame fits maxLen.
+ */
+bool PacketTranslator::applyFec(uint8_t *frame, uint16_t &len, uint16_t maxLen, uint8_t level) {
+    if (len < MESHXT_COMPRESS_HEADER_SIZE ||
+        frame[0] != MESHXT_MAGIC_0 || frame[1] != MESHXT_MAGIC_1) return false;
+
+    uint16_t dataLen = len - MESHXT_COMPRESS_HEADER_SIZE;
+    while (level > MESHXT_FEC_NONE_CODE &&
+           (len + meshxt_fec_nsym_from_code(level) > maxLen ||
+            dataLen + meshxt_fec_nsym_from_code(level) > 255)) {  // RS codeword limit
+        level--;
+    }
+    if (level == MESHXT_FEC_NONE_CODE) return false;
+
+    uint8_t *data = frame + MESHXT_COMPRESS_HEADER_SIZE;
+    uint8_t nsym = meshxt_fec_nsym_from_code(level);
+    if (meshxt_fec_encode(data, dataLen, data, nsym) < 0) return false;
+
+    frame[2] = (frame[2] & ~MESHXT_CTRL_FEC_MASK) | level;
+    len += nsym;
+    return true;
+}
+
+/**
+ * Correct and remove RS parity from an MX frame in place, clearing the
+ * control FEC bits. Frames without parity (or without the MX header)
+ * pass through. Repaired-symbol counts feed the adaptive controller.
+ *
+ * @return false if the parity could not correct the frame
+ */
+bool PacketTranslator::stripFec(uint8_t *frame, uint16_t &len) {
+    if (len < MESHXT_COMPRESS_HEADER_SIZE ||
+        frame[0] != MESHXT_MAGIC_0 || frame[1] != MESHXT_MAGIC_1) return true;
+
+    uint8_t level = frame[2] & MESHXT_CTRL_FEC_MASK;
+    if (level == MESHXT_FEC_NONE_CODE) return true;
+
+    uint8_t *data = frame + MESHXT_COMPRESS_HEADER_SIZE;
+    uint8_t nsym = meshxt_fec_nsym_from_code(level);
+    uint8_t corrected = 0;
+    int msgLen = meshxt_fec_decode_erasures(data, len - MESHXT_COMPRESS_HEADER_SIZE, data, nsym,
+                                            NULL, 0, &corrected);
+
+    // An uncorrectable frame counts as one symbol beyond this level's capacity
+    float errors = msgLen < 0 ? (float)(nsym / 2 + 1) : (float)corrected;
+    _fecErrorsAvg  = _haveFecErrors ? _fecErrorsAvg + (errors - _fecErrorsAvg) * 0.25f : errors;
+    _haveFecErrors = true;
+
+    if (msgLen < 0) return false;
+
+    frame[2] &= ~MESHXT_CTRL_FEC_MASK;
+    len = MESHXT_COMPRESS_HEADER_SIZE + msgLen;
+    return true;
+}
+
+void PacketTranslator::reportUplink(bool delivered) {
+    _uplinkHistory = (_uplinkHistory << 1) | (delivered ? 0 : 1);
+    if (_uplinkSamples < FEC_ADAPT_HISTORY) _uplinkSamples++;
+}
+
+void PacketTranslator::reportDownlinkSnr(float snr) {
+    _snrAvg  = _haveSnr ? _snrAvg + (snr - _snrAvg) * 0.25f : snr;
+    _haveSnr = true;
+}
+
+/**
+ * FEC level code for the next packet of this priority: the strongest
+ * level asked for by downlink SNR, recent uplink loss or the symbols the
+ * decoder has been repairing, and never below the priority floor.
+ */
+uint8_t PacketTranslator::fecLevelFor(uint8_t priority) const {
+    uint8_t level = MESHXT_FEC_NONE_CODE;
+    bool haveStats = false;
+
+    if (_haveSnr) {
+        uint8_t l = _snrAvg >= FEC_ADAPT_SNR_GOOD ? MESHXT_FEC_NONE_CODE
+                  : _snrAvg >= FEC_ADAPT_SNR_FAIR ? MESHXT_FEC_LOW_CODE
+                  : _snrAvg >= FEC_ADAPT_SNR_POOR ? MESHXT_FEC_MEDIUM_CODE
+                  : MESHXT_FEC_HIGH_CODE;
+        if (l > level) level = l;
+        haveStats = true;
+    }
+
+    if (_uplinkSamples >= 4) {
+        uint32_t window = _uplinkSamples >= 32 ? 0xFFFFFFFFu : ((1u << _uplinkSamples) - 1);
+        uint8_t failed = 0;
+        for (uint32_t bits = _uplinkHistory & window; bits; bits &= bits - 1) failed++;
+        uint8_t lossPct = (uint8_t)(failed * 100 / _uplinkSamples);
+        uint8_t l = lossPct > FEC_ADAPT_LOSS_POOR ? MESHXT_FEC_HIGH_CODE
+                  : lossPct > FEC_ADAPT_LOSS_FAIR ? MESHXT_FEC_MEDIUM_CODE
+                  : lossPct > 0 ? MESHXT_FEC_LOW_CODE
+                  : MESHXT_FEC_NONE_CODE;
+        if (l > level) level = l;
+        haveStats = true;
+    }
+
+    if (_haveFecErrors) {
+        // Keep correction capacity (nsym/2) at least twice the recent error count
+        uint8_t l = _fecErrorsAvg <= 0.0f ? MESHXT_FEC_NONE_CODE
+                  : _fecErrorsAvg <= 4.0f ? MESHXT_FEC_LOW_CODE
+                  : _fecErrorsAvg <= 8.0f ? MESHXT_FEC_MEDIUM_CODE
+                  : MESHXT_FEC_HIGH_CODE;
+        if (l > level) level = l;
+        haveStats = true;
+    }
+
+    if (!haveStats) level = FEC_ADAPT_DEFAULT_LEVEL;
+
+    uint8_t floor;
+    switch (priority) {
+        case PRIORITY_EMERGENCY: floor = FEC_FLOOR_EMERGENCY; break;
+        case PRIORITY_HIGH:      floor = FEC_FLOOR_HIGH;      break;
+        case PRIORITY_NORMAL:    floor = FEC_FLOOR_NORMAL;    break;
+        default:                 floor = FEC_FLOOR_LOW;       break;
+    }
+    return level > floor ? level : floor;
+}
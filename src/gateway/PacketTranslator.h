@@ -9,10 +9,28 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "MeshtasticReceiver.h"
+#include "config.h"
+#include "../meshxt/MeshXTPosition.h"
+#include "../meshxt/MeshXTFragment.h"
+#include "../meshxt/MeshXTNodeTable.h"
 
-#define RELAY_VERSION          1
-#define RELAY_HEADER_SIZE      14   // version(1) + src(4) + dest(4) + channel(1) + timestamp(4)
-#define MAX_SATELLITE_PAYLOAD  128
+#define RELAY_VERSION_1        1    // version(1) + src(4) + dest(4) + channel(1) + timestamp(4)
+#define RELAY_VERSION_2        2    // Compact: [VVVV TTTT], node table index, minutes
+#define RELAY_VERSION          (RELAY_COMPACT_HEADER ? RELAY_VERSION_2 : RELAY_VERSION_1)
+#define RELAY_HEADER_SIZE      14   // v1 header, and the largest v2 header
+
+// Message types (v2 header low nibble)
+#define RELAY_TYPE_TEXT        0x01
+#define RELAY_TYPE_SOS         0x02
+#define RELAY_TYPE_POS         0x03
+#define RELAY_TYPE_ACK         0x04
+#define RELAY_TYPE_PING        0x05
+
+// v2 sender field: varint (node index << 4) | (binding generation << 2) | flags
+#define RELAY_V2_NODE_ID       0x01 // Full sender node ID follows
+#define RELAY_V2_DEST          0x02 // Destination follows; absent = broadcast
+#define MAX_SATELLITE_PAYLOAD  128  // One uplink
+#define MAX_RELAY_FRAME        (RELAY_HEADER_SIZE + 3 + MESHTASTIC_MAX_PACKET)  // + MX header + raw message
 
 // Priority levels
 #define PRIORITY_EMERGENCY  0
@@ -20,13 +38,26 @@
 #define PRIORITY_NORMAL     2
 #define PRIORITY_LOW        3
 
+// Fragmented relay frame kept until the ground confirms it
+struct HeldFrame {
+    bool     active;
+    uint8_t  id;
+    uint8_t  priority;
+    uint32_t entryId;       // Queue id of the message, kept by resent fragments
+    uint16_t maxFragment;
+    uint16_t len;
+    uint32_t heldAt;
+    uint8_t  frame[MAX_RELAY_FRAME];
+};
+
 struct SatellitePacket {
     uint8_t  version;
+    uint8_t  type;          // RELAY_TYPE_*
     uint32_t sourceNode;
     uint32_t destNode;
     uint8_t  channel;
     uint32_t timestamp;
-    uint8_t  payload[MAX_SATELLITE_PAYLOAD - RELAY_HEADER_SIZE];
+    uint8_t  payload[MAX_RELAY_FRAME - RELAY_HEADER_SIZE];
     uint16_t payloadLen;
     uint8_t  priority;
 };
@@ -43,10 +74,56 @@ public:
     bool fromSatellite(const uint8_t *data, uint16_t len, SatellitePacket &satPkt);
     bool toMeshtastic(const SatellitePacket &satPkt, uint8_t *out, uint16_t &outLen);
 
+    // Fragmentation of relay frames larger than one uplink
+    bool    holdFragments(const uint8_t *frame, uint16_t len, uint16_t maxFragment,
+                          uint8_t priority, uint32_t entryId, uint8_t &msgId, uint8_t &count);
+    bool    buildFragment(uint8_t msgId, uint8_t index, uint8_t *out, uint16_t &outLen,
+                          uint8_t &priority);
+    bool    fragmentStatus(const uint8_t *data, uint16_t len, uint8_t &msgId, uint16_t &missing,
+                           uint32_t &entryId);
+    int     reassemble(const uint8_t *data, uint16_t len, uint8_t *out, uint16_t &outLen);
+    void    expireFragments();
+
+    // Link feedback for adaptive FEC. Uplinks that were attempted only:
+    // a duty-cycle deferral is not a loss
+    void    reportUplink(bool delivered);
+    void    reportDownlinkSnr(float snr);
+    uint8_t fecLevelFor(uint8_t priority) const;
+
 private:
+    // Adaptive FEC statistics
+    uint32_t _uplinkHistory;    // One bit per recent uplink, newest in bit 0, 1 = failed
+    uint8_t  _uplinkSamples;
+    float    _snrAvg;           // Downlink SNR (dB), EWMA
+    bool     _haveSnr;
+    float    _fecErrorsAvg;     // Symbols repaired per downlink, EWMA
+    bool     _haveFecErrors;
+
+    // v2 header node indices: ours (uplink) and the ground's (downlink)
+    MeshXTNodeSlot   _txNodes[RELAY_NODE_SLOTS];
+    MeshXTNodeSlot   _rxNodes[RELAY_NODE_SLOTS];
+    bool             _txNodesSeeded;    // Generations seeded for this boot
+
+    // Fragmentation
+    HeldFrame        _held[FRAGMENT_TX_SLOTS];
+    uint8_t          _nextFragmentId;
+    MeshXTReassembly _reassembly[FRAGMENT_RX_SLOTS];
+
+    // Delta state of the nodes whose positions we relay
+    MeshXTPositionTrack _posTracks[POSITION_TRACK_NODES];
+
     uint8_t determinePriority(const MeshtasticPacket &pkt);
-    bool    compressPayload(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t &outLen);
-    bool    decompressPayload(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t &outLen);
+    bool    serializeV2(const SatellitePacket &satPkt, uint8_t *out, uint16_t &outLen);
+    bool    parseV1(const uint8_t *data, uint16_t len, SatellitePacket &satPkt);
+    bool    parseV2(const uint8_t *data, uint16_t len, SatellitePacket &satPkt);
+    bool    compressPayload(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t &outLen,
+                            uint16_t maxLen, uint8_t priority);
+    bool    encodePosition(const MeshtasticPacket &meshPkt, SatellitePacket &satPkt);
+    uint8_t fecLevel(uint8_t priority) const;
+    bool    decompressPayload(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t &outLen,
+                              uint16_t maxLen);
+    bool    applyFec(uint8_t *frame, uint16_t &len, uint16_t maxLen, uint8_t level);
+    bool    stripFec(uint8_t *frame, uint16_t &len);
 };
 
 #endif // PACKET_TRANSLATOR_H
@@ -0,0 +1,120 @@
+/**
+ * PassPlanner — Chooses which queued frames fit the rest of a pass
+ * © Mikoshi Ltd. — Apache 2.0
+ */
+
+#include "PassPlanner.h"
+#include "../meshxt/MeshXTOuterFEC.h"
+#include <string.h>
+
+static_assert(PLANNER_MAX_ITEMS > 0 && PLANNER_QUANTA > 0 && PLANNER_QUANTA <= 0xFFFF,
+              "PLANNER_MAX_ITEMS and PLANNER_QUANTA must be positive");
+static_assert((uint64_t)PLANNER_VALUE_EMERGENCY * PLANNER_MAX_ITEMS * PLANNER_MAX_ITEMS *
+              PLANNER_MAX_ITEMS < 0xFFFFFFFFull,
+              "Plan values must fit 32 bits");
+
+PassPlanner::PassPlanner()
+    : _planned(0)
+    , _plannedAirtimeMs(0) {
+#if OUTER_FEC_ENABLED
+    memset(_parityShare, 0, sizeof(_parityShare));
+#endif
+}
+
+#if OUTER_FEC_ENABLED
+void PassPlanner::setParity(uint8_t priority, uint8_t k, uint8_t m) {
+    if (priority > PRIORITY_LOW) return;
+    _parityShare[priority] = (k == 0 || m == 0) ? 0 : (uint16_t)(((uint32_t)m * 256 + k - 1) / k);
+}
+#endif
+
+uint32_t PassPlanner::valueOf(uint8_t priority) {
+    switch (priority) {
+        case PRIORITY_EMERGENCY: return PLANNER_VALUE_EMERGENCY;
+        case PRIORITY_HIGH:      return PLANNER_VALUE_HIGH;
+        case PRIORITY_NORMAL:    return PLANNER_VALUE_NORMAL;
+        default:                 return PLANNER_VALUE_LOW;
+    }
+}
+
+QueueEntry *PassPlanner::next(MessageQueue &queue, const LoRaWANTransmitter &radio,
+                              uint32_t passLeftMs, uint32_t dutyLeftMs) {
+    _planned = 0;
+    _plannedAirtimeMs = 0;
+    if (passLeftMs == 0 || dutyLeftMs == 0) return NULL;
+
+    // Candidates in send order, with their airtime and pass time
+    uint16_t n = 0;
+    uint64_t sumAirtime = 0;
+    uint64_t sumPass = 0;
+    for (uint8_t p = PRIORITY_EMERGENCY; p <= PRIORITY_LOW && n < PLANNER_MAX_ITEMS; p++) {
+        for (QueueEntry *e = queue.first(p); e && n < PLANNER_MAX_ITEMS; e = queue.next(e)) {
+            // Too long for the data rate: never sent, left for its TTL
+            if (e->payloadLen > radio.maxPayload()) continue;
+            _items[n]    = e;
+            _airtime[n]  = radio.airtimeMs(e->payloadLen);
+            _passTime[n] = _airtime[n] + PLANNER_TX_GAP_MS;
+#if OUTER_FEC_ENABLED
+            uint16_t share = _parityShare[p];
+            if (share > 0) {
+                // Tagged, and its part of the group's parity frames
+                uint32_t air = radio.airtimeMs(e->payloadLen + MESHXT_OUTER_DATA_HEADER);
+                uint32_t parity = radio.airtimeMs(e->payloadLen + MESHXT_OUTER_PARITY_HEADER + 1);
+                _airtime[n]  = air + (parity * share + 255) / 256;
+                _passTime[n] = air + PLANNER_TX_GAP_MS +
+                               ((parity + PLANNER_TX_GAP_MS) * share + 255) / 256;
+            }
+#endif
+            sumAirtime += _airtime[n];
+            sumPass += _passTime[n];
+            n++;
+        }
+    }
+    if (n == 0) return NULL;
+
+    if (sumPass <= passLeftMs && sumAirtime <= dutyLeftMs) {
+        _planned = n;
+        _plannedAirtimeMs = (uint32_t)sumAirtime;
+        return _items[0];
+    }
+
+    // Cost in steps of PLANNER_QUANTA per budget: the larger of its share
+    // of the pass time and its share of the duty cycle, rounded up once
+    const uint16_t capacity = PLANNER_QUANTA;
+    for (uint16_t i = 0; i < n; i++) {
+        uint64_t pass = ((uint64_t)_passTime[i] * capacity + passLeftMs - 1) / passLeftMs;
+        uint64_t duty = ((uint64_t)_airtime[i] * capacity + dutyLeftMs - 1) / dutyLeftMs;
+        uint64_t q = pass > duty ? pass : duty;
+        _cost[i] = q > capacity ? (uint16_t)(capacity + 1) : (uint16_t)q;
+    }
+
+    // Priority value first; below one unit of it, the earlier candidate
+    const uint32_t unit = (uint32_t)PLANNER_MAX_ITEMS * PLANNER_MAX_ITEMS;
+
+    memset(_best, 0, sizeof(_best[0]) * (capacity + 1));
+    for (uint16_t i = 0; i < n; i++) {
+        memset(_take[i], 0, capacity / 8 + 1);
+        if (_cost[i] > capacity) continue;
+
+        uint32_t value = valueOf(_items[i]->priority) * unit + (PLANNER_MAX_ITEMS - 1 - i);
+        for (uint16_t c = capacity; c >= _cost[i]; c--) {
+            uint32_t v = _best[c - _cost[i]] + value;
+            if (v > _best[c]) {
+                _best[c] = v;
+                _take[i][c / 8] |= (uint8_t)(1 << (c % 8));
+            }
+        }
+    }
+
+    // Walk the choices back; the last one found is the first to send
+    QueueEntry *first = NULL;
+    uint16_t c = capacity;
+    for (uint16_t i = n; i-- > 0;) {
+        if (!(_take[i][c / 8] & (1 << (c % 8)))) continue;
+        first = _items[i];
+        c -= _cost[i];
+        _planned++;
+        _plannedAirtimeMs += _airtime[i];
+    }
+    return first;
+}
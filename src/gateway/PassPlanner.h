@@ -0,0 +1,75 @@
+/**
+ * PassPlanner — Chooses which queued frames fit the rest of a pass
+ * © Mikoshi Ltd. — Apache 2.0
+ */
+
+#ifndef PASS_PLANNER_H
+#define PASS_PLANNER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MessageQueue.h"
+#include "LoRaWANTransmitter.h"
+#include "config.h"
+
+/**
+ * Picks the next uplink as a 0/1 knapsack over the queue. Each candidate
+ * is worth the value of its priority (PLANNER_VALUE_*) and costs its time
+ * on air at the configured data rate. The budget is the smaller of the
+ * pass time left and the duty cycle left. The set with the most value is
+ * sent highest priority first, oldest first.
+ *
+ * The two budgets are folded into one of PLANNER_QUANTA steps: a frame
+ * costs the larger of its share of the pass time left (airtime +
+ * PLANNER_TX_GAP_MS) and its share of the duty cycle left (airtime),
+ * rounded up. A frame of a priority with outer parity (setParity()) also
+ * pays M/K of a parity frame of its own length, gap included. A set that fits the steps therefore fits both budgets, and
+ * a frame that fits them on its own is never left out for rounding.
+ * Among plans of equal value, older frames win.
+ * The first PLANNER_MAX_ITEMS frames in send order are considered. If
+ * they all fit, no table is built.
+ *
+ * The budgets come from the caller, less anything it has reserved (the
+ * gateway keeps back parity still owed by open outer groups). Frames
+ * longer than the data rate allows are left out.
+ *
+ * The plan is made again before every uplink (next()). Results that
+ * change the queue or the budget, such as a failed send, a container
+ * carrying extra frames, or fragments queued by a downlink, shape the
+ * next choice.
+ */
+class PassPlanner {
+public:
+    PassPlanner();
+
+    // Entry to send next, still queued; NULL if nothing fits the budgets
+    QueueEntry *next(MessageQueue &queue, const LoRaWANTransmitter &radio,
+                     uint32_t passLeftMs, uint32_t dutyLeftMs);
+
+#if OUTER_FEC_ENABLED
+    // Outer FEC shape of a priority: M parity frames per K data frames
+    void setParity(uint8_t priority, uint8_t k, uint8_t m);
+#endif
+
+    // Result of the last plan
+    uint16_t planned() const { return _planned; }
+    uint32_t plannedAirtimeMs() const { return _plannedAirtimeMs; }
+
+private:
+    QueueEntry *_items[PLANNER_MAX_ITEMS];
+    uint32_t    _airtime[PLANNER_MAX_ITEMS];
+    uint32_t    _passTime[PLANNER_MAX_ITEMS];
+    uint16_t    _cost[PLANNER_MAX_ITEMS];
+    uint32_t    _best[PLANNER_QUANTA + 1];
+    uint8_t     _take[PLANNER_MAX_ITEMS][PLANNER_QUANTA / 8 + 1];
+
+    uint16_t _planned;
+    uint32_t _plannedAirtimeMs;
+#if OUTER_FEC_ENABLED
+    uint16_t _parityShare[PRIORITY_LOW + 1];  // Parity frames per data frame, in 1/256
+#endif
+
+    static uint32_t valueOf(uint8_t priority);
+};
+
+#endif // PASS_PLANNER_H
@@ -0,0 +1,368 @@
+/**
+ * QueueStore — Crash-safe log of the store & forward queue
+ * © Mikoshi Ltd. — Apache 2.0
+ */
+
+#include "QueueStore.h"
+#include <Arduino.h>
+#include <string.h>
+
+#if STORE_ENABLED && defined(ESP32)
+#include <LittleFS.h>
+#include <unistd.h>
+#define STORE_BACKEND 1
+#elif STORE_ENABLED && defined(__linux__)
+#include <unistd.h>
+#define STORE_BACKEND 1
+#else
+#define STORE_BACKEND 0
+#endif
+
+#define STORE_MAGIC       0xA5
+#define STORE_ADD         1
+#define STORE_DEL         2
+#define STORE_RETRY       3
+#define STORE_CLOCK       4
+#define STORE_HEADER      4
+#define STORE_CRC         4
+#define STORE_ADD_BODY    16     // Fixed fields before the payload
+#define STORE_MAX_BODY    (STORE_ADD_BODY + MAX_SATELLITE_PAYLOAD)
+#define STORE_MAX_RECORD  (STORE_HEADER + STORE_MAX_BODY + STORE_CRC)
+#define STORE_CLOCK_RECORD (STORE_HEADER + 4 + STORE_CRC)
+
+static_assert(STORE_BUFFER_BYTES >= STORE_MAX_RECORD + STORE_CLOCK_RECORD,
+              "STORE_BUFFER_BYTES must hold the largest record and a checkpoint");
+
+// CRC-32 (IEEE, reflected), nibble table
+static uint32_t crc32(const uint8_t *data, size_t len) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+        0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+static inline void putBE32(uint8_t *p, uint32_t v) {
+    p[0] = (v >> 24) & 0xFF;
+    p[1] = (v >> 16) & 0xFF;
+    p[2] = (v >> 8)  & 0xFF;
+    p[3] = v & 0xFF;
+}
+
+static inline uint32_t getBE32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// Header, body and CRC into out; returns the record length
+static uint16_t writeRecord(uint8_t *out, uint8_t type, const uint8_t *body, uint16_t bodyLen) {
+    out[0] = STORE_MAGIC;
+    out[1] = type;
+    out[2] = (bodyLen >> 8) & 0xFF;
+    out[3] = bodyLen & 0xFF;
+    memcpy(out + STORE_HEADER, body, bodyLen);
+    putBE32(out + STORE_HEADER + bodyLen, crc32(out, STORE_HEADER + bodyLen));
+    return STORE_HEADER + bodyLen + STORE_CRC;
+}
+
+QueueStore::QueueStore()
+    : _log(NULL)
+    , _logBytes(0)
+    , _nextKey(1)
+    , _bufLen(0)
+    , _bufSince(0)
+    , _clockAt(0)
+    , _clockOffset(0)
+    , _compactAt(0)
+    , _compactFailed(false) {}
+
+QueueStore::~QueueStore() {
+    if (_log) fclose(_log);
+}
+
+bool QueueStore::begin() {
+#if STORE_BACKEND
+#if defined(ESP32)
+    if (!LittleFS.begin(true)) {  // Formats an unformatted partition
+        Serial.println("[Store] LittleFS mount failed, queue is RAM-only.");
+        return false;
+    }
+#endif
+    _log = fopen(STORE_PATH, "a+b");
+    if (!_log) {
+        Serial.printf("[Store] Cannot open %s, queue is RAM-only.\n", STORE_PATH);
+        return false;
+    }
+    fseek(_log, 0, SEEK_END);
+    _logBytes = (uint32_t)ftell(_log);
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Queued entry with a store key; removals and retries are few between
+// compactions, so a scan is enough
+static QueueEntry *findKey(MessageQueue &queue, uint32_t key) {
+    for (uint8_t p = PRIORITY_EMERGENCY; p <= PRIORITY_LOW; p++) {
+        for (QueueEntry *e = queue.first(p); e; e = queue.next(e)) {
+            if (e->storeKey == key) return e;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Replay the log: ADD queues an entry, DEL removes it again, RETRY
+ * updates its retry count, CLOCK advances the log clock. Stops at the
+ * first damaged or truncated record, then rewrites the log with the live
+ * entries only, which also cuts off a torn tail before anything is
+ * appended after it.
+ */
+uint16_t QueueStore::restore(MessageQueue &queue, uint64_t now) {
+    if (!_log) return 0;
+
+    uint8_t  rec[STORE_MAX_RECORD];
+    uint16_t dropped = 0;
+    uint32_t good = 0;
+    uint32_t clock = 0;
+
+    fseek(_log, 0, SEEK_SET);
+    for (;;) {
+        if (fread(rec, 1, STORE_HEADER, _log) != STORE_HEADER) break;
+        uint16_t bodyLen = (uint16_t)((rec[2] << 8) | rec[3]);
+        if (rec[0] != STORE_MAGIC || bodyLen < 4 || bodyLen > STORE_MAX_BODY) break;
+        if (fread(rec + STORE_HEADER, 1, bodyLen + STORE_CRC, _log) != (size_t)bodyLen + STORE_CRC) break;
+        if (getBE32(rec + STORE_HEADER + bodyLen) != crc32(rec, STORE_HEADER + bodyLen)) break;
+        good += STORE_HEADER + bodyLen + STORE_CRC;
+
+        const uint8_t *b = rec + STORE_HEADER;
+        if (rec[1] == STORE_CLOCK) {
+            if (bodyLen != 4) break;
+            clock = getBE32(b);
+            continue;
+        }
+
+        uint32_t key = getBE32(b);
+        if (key >= _nextKey) _nextKey = key + 1;
+
+        if (rec[1] == STORE_DEL) {
+            if (bodyLen != 4) break;
+            QueueEntry *found = findKey(queue, key);
+            if (found) queue.remove(found);
+            continue;
+        }
+        if (rec[1] == STORE_RETRY) {
+            if (bodyLen != 5) break;
+            QueueEntry *found = findKey(queue, key);
+            if (found) found->retries = b[4];
+            continue;
+        }
+
+        uint16_t payloadLen = (uint16_t)((b[14] << 8) | b[15]);
+        if (rec[1] != STORE_ADD || bodyLen != STORE_ADD_BODY + payloadLen) break;
+
+        QueueEntry *entry = queue.alloc(payloadLen);
+        if (!entry) {
+            dropped++;
+            continue;
+        }
+        entry->storeKey   = key;
+        entry->id         = getBE32(b + 4);
+        entry->priority   = b[8];
+        entry->retries    = b[9];
+        entry->expires    = getBE32(b + 10);  // Log clock until the replay ends
+        memcpy(queue.payload(entry), b + STORE_ADD_BODY, payloadLen);
+        queue.push(entry);
+    }
+
+    // The log clock resumes where the last checkpoint left it. Moving every
+    // expiry onto the gateway clock (and what already ran out to now) keeps
+    // their order, so the expiry heap stays valid.
+    uint32_t nowSec = (uint32_t)(now / 1000);
+    _clockOffset = clock - nowSec;
+    for (uint8_t p = PRIORITY_EMERGENCY; p <= PRIORITY_LOW; p++) {
+        for (QueueEntry *e = queue.first(p); e; e = queue.next(e)) {
+            int32_t left = (int32_t)(e->expires - clock);
+            e->expires = left > 0 ? nowSec + (uint32_t)left : nowSec;
+        }
+    }
+
+    if (good < _logBytes) {
+        Serial.printf("[Store] Discarded %d damaged bytes at end of log.\n",
+            (int)(_logBytes - good));
+    }
+    if (dropped > 0) {
+        Serial.printf("[Store] %d stored messages did not fit the queue.\n", dropped);
+    }
+
+    compact(queue, now);
+    return queue.count();
+}
+
+uint16_t QueueStore::encodeAdd(const QueueEntry &entry, const uint8_t *payload,
+                               uint8_t *out) const {
+    putBE32(out, entry.storeKey);
+    putBE32(out + 4, entry.id);
+    out[8] = entry.priority;
+    out[9] = entry.retries;
+    putBE32(out + 10, entry.expires + _clockOffset);
+    out[14] = (entry.payloadLen >> 8) & 0xFF;
+    out[15] = entry.payloadLen & 0xFF;
+    memcpy(out + STORE_ADD_BODY, payload, entry.payloadLen);
+    return STORE_ADD_BODY + entry.payloadLen;
+}
+
+/**
+ * Log a newly queued entry, assigning its store key. Emergency messages
+ * are written at once rather than with the next batch.
+ */
+void QueueStore::recordAdd(QueueEntry &entry, const uint8_t *payload, uint64_t now) {
+    if (!_log) return;
+
+    entry.storeKey = _nextKey++;
+    uint8_t body[STORE_MAX_BODY];
+    append(STORE_ADD, body, encodeAdd(entry, payload, body), now);
+    if (entry.priority == PRIORITY_EMERGENCY) flush(now);
+}
+
+void QueueStore::recordRemove(const QueueEntry &entry, uint64_t now) {
+    if (!_log) return;
+
+    uint8_t body[4];
+    putBE32(body, entry.storeKey);
+    append(STORE_DEL, body, sizeof(body), now);
+}
+
+/**
+ * Log a failed send: the entry is queued again with one more retry.
+ */
+void QueueStore::recordRetry(const QueueEntry &entry, uint64_t now) {
+    if (!_log) return;
+
+    uint8_t body[5];
+    putBE32(body, entry.storeKey);
+    body[4] = entry.retries;
+    append(STORE_RETRY, body, sizeof(body), now);
+}
+
+void QueueStore::append(uint8_t type, const uint8_t *body, uint16_t bodyLen, uint64_t now) {
+    // Room is kept for the CLOCK record that closes the batch
+    if ((size_t)_bufLen + STORE_HEADER + bodyLen + STORE_CRC + STORE_CLOCK_RECORD > sizeof(_buf)) {
+        flush(now);
+    }
+    if (_bufLen == 0) _bufSince = now;
+    _bufLen += writeRecord(_buf + _bufLen, type, body, bodyLen);
+}
+
+void QueueStore::flush(uint64_t now) {
+    if (!_log || _bufLen == 0) return;
+    checkpoint(now);
+}
+
+/**
+ * Write the buffered records, closed by a CLOCK record with the log
+ * clock now.
+ */
+void QueueStore::checkpoint(uint64_t now) {
+    uint8_t body[4];
+    putBE32(body, logClock(now));
+    _bufLen += writeRecord(_buf + _bufLen, STORE_CLOCK, body, sizeof(body));
+    _clockAt = now;
+
+    size_t written = fwrite(_buf, 1, _bufLen, _log);
+    fflush(_log);
+#if STORE_BACKEND
+    fsync(fileno(_log));
+#endif
+    if (written != _bufLen && DEBUG_SERIAL) {
+        Serial.printf("[Store] Short write (%d of %d bytes).\n", (int)written, _bufLen);
+    }
+    _logBytes += (uint32_t)written;
+    _bufLen = 0;
+}
+
+void QueueStore::poll(MessageQueue &queue, uint64_t now, bool idle) {
+    if (!_log) return;
+
+    if (_bufLen > 0 && now - _bufSince >= STORE_FLUSH_MS) flush(now);
+    // Queued messages age while nothing is logged, too
+    if (_bufLen == 0 && queue.count() > 0 && now - _clockAt >= STORE_CLOCK_MS) checkpoint(now);
+
+    if (idle && _logBytes + _bufLen > STORE_COMPACT_BYTES && now >= _compactAt) {
+        if (compact(queue, now)) {
+            _compactFailed = false;
+        } else {
+            if (!_compactFailed) Serial.println("[Store] Log compaction failed, will retry later.");
+            _compactFailed = true;
+            _compactAt = now + STORE_COMPACT_RETRY_MS;
+        }
+    }
+}
+
+/**
+ * Rewrite the log as one ADD per queued entry and a CLOCK record: written
+ * to a temporary file, synced, then renamed over the log, so power loss at
+ * any point leaves either the old or the new log intact. Returns false if
+ * the old log is still the one in use.
+ */
+bool QueueStore::compact(MessageQueue &queue, uint64_t now) {
+    flush(now);
+
+    static const char tmpPath[] = STORE_PATH ".tmp";
+    FILE *out = fopen(tmpPath, "wb");
+    if (!out) return false;
+
+    uint8_t  body[STORE_MAX_BODY];
+    uint8_t  rec[STORE_MAX_RECORD];
+    uint32_t bytes = 0;
+    bool     ok = true;
+
+    for (uint8_t p = PRIORITY_EMERGENCY; p <= PRIORITY_LOW && ok; p++) {
+        for (QueueEntry *e = queue.first(p); e && ok; e = queue.next(e)) {
+            uint16_t len = writeRecord(rec, STORE_ADD, body,
+                                       encodeAdd(*e, queue.payload(e), body));
+            ok = fwrite(rec, 1, len, out) == len;
+            bytes += len;
+        }
+    }
+    if (ok) {
+        putBE32(body, logClock(now));
+        uint16_t len = writeRecord(rec, STORE_CLOCK, body, 4);
+        ok = fwrite(rec, 1, len, out) == len;
+        bytes += len;
+    }
+    ok = ok && fflush(out) == 0;
+#if STORE_BACKEND
+    ok = ok && fsync(fileno(out)) == 0;
+#endif
+    fclose(out);
+
+    if (!ok) {
+        remove(tmpPath);
+        return false;
+    }
+
+    fclose(_log);
+    bool renamed = rename(tmpPath, STORE_PATH) == 0;
+    if (!renamed) remove(tmpPath);
+    _log = fopen(STORE_PATH, "a+b");
+    if (!_log) {
+        Serial.println("[Store] Log lost after compaction, queue is RAM-only.");
+        return false;
+    }
+    fseek(_log, 0, SEEK_END);
+    _logBytes = (uint32_t)ftell(_log);
+    if (!renamed) return false;
+    _clockAt = now;
+
+    if (DEBUG_SERIAL) {
+        Serial.printf("[Store] Compacted log to %d bytes.\n", (int)bytes);
+    }
+    return true;
+}
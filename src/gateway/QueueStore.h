@@ -0,0 +1,93 @@
+/**
+ * QueueStore — Crash-safe log of the store & forward queue
+ * © Mikoshi Ltd. — Apache 2.0
+ */
+
+#ifndef QUEUE_STORE_H
+#define QUEUE_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "MessageQueue.h"
+#include "config.h"
+
+/**
+ * Append-only log of queue changes: an ADD record when an entry is queued,
+ * a RETRY record when a failed send puts it back, a DEL record when it
+ * leaves for good (sent, expired, dropped), and a CLOCK record with the
+ * log's clock at the end of every write.
+ *
+ * Record:
+ *   Byte 0:     0xA5 magic
+ *   Byte 1:     Type (1 = ADD, 2 = DEL, 3 = RETRY, 4 = CLOCK)
+ *   Byte 2-3:   Body length (big-endian)
+ *   Body:       DEL: key(4)
+ *               RETRY: key(4) retries(1)
+ *               CLOCK: log clock in seconds(4)
+ *               ADD: key(4) id(4) priority(1) retries(1)
+ *                    expiry on the log clock(4) payload length(2) payload
+ *   Then:       CRC-32 of the bytes above (big-endian)
+ *
+ * The log clock counts seconds the gateway has run, across reboots: on
+ * boot it resumes from the last CLOCK record. An entry's TTL therefore
+ * runs until that last checkpoint and pauses while the gateway is off.
+ * While entries are queued a CLOCK record is also written every
+ * STORE_CLOCK_MS, so a reboot forgets at most that much of their age.
+ *
+ * Records are batched in RAM and written every STORE_FLUSH_MS, when the
+ * buffer fills, or at once for an emergency message. On boot the log is
+ * replayed up to the first damaged record (a write torn by power loss),
+ * the surviving entries are queued again, and the log is rewritten with
+ * only those. It is rewritten the same way between passes once it grows
+ * past STORE_COMPACT_BYTES. A rewrite that fails (full flash, say) is
+ * not tried again for STORE_COMPACT_RETRY_MS.
+ *
+ * The backend is a stdio file: LittleFS through the VFS on ESP32, a plain
+ * file on Linux. Elsewhere, or if the file cannot be opened, the store
+ * does nothing and the queue is RAM-only.
+ *
+ * Only the queue is logged. The frames PacketTranslator holds so that
+ * missing fragments can be rebuilt are lost on reboot: queued fragments
+ * still go out, but a fragment status for a message sent before the
+ * reboot cannot be answered, and the ground times the message out.
+ */
+class QueueStore {
+public:
+    QueueStore();
+    ~QueueStore();  // Closes the log; records still batched are lost, as on power loss
+
+    bool begin();
+    bool active() const { return _log != NULL; }
+
+    // Replay the log into an empty queue; returns entries restored
+    uint16_t restore(MessageQueue &queue, uint64_t now);
+
+    void recordAdd(QueueEntry &entry, const uint8_t *payload, uint64_t now);
+    void recordRemove(const QueueEntry &entry, uint64_t now);
+    void recordRetry(const QueueEntry &entry, uint64_t now);
+
+    // Flush due batches; compact only when idle (not during a pass)
+    void poll(MessageQueue &queue, uint64_t now, bool idle);
+    void flush(uint64_t now);
+
+private:
+    FILE    *_log;
+    uint32_t _logBytes;
+    uint32_t _nextKey;
+    uint8_t  _buf[STORE_BUFFER_BYTES];
+    uint16_t _bufLen;
+    uint64_t _bufSince;     // When the oldest buffered record was added
+    uint64_t _clockAt;      // When the last CLOCK record was written
+    uint32_t _clockOffset;  // Log clock minus the gateway clock, seconds
+    uint64_t _compactAt;    // No rewrite before this, after one failed
+    bool     _compactFailed;
+
+    uint32_t logClock(uint64_t now) const { return (uint32_t)(now / 1000) + _clockOffset; }
+    void append(uint8_t type, const uint8_t *body, uint16_t bodyLen, uint64_t now);
+    void checkpoint(uint64_t now);
+    bool compact(MessageQueue &queue, uint64_t now);
+    uint16_t encodeAdd(const QueueEntry &entry, const uint8_t *payload, uint8_t *out) const;
+};
+
+#endif // QUEUE_STORE_H
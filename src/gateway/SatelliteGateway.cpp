@@ -7,10 +7,25 @@
 #include <Arduino.h>
 
 SatelliteGateway::SatelliteGateway()
-    : _queueCount(0)
-    , _lastPassTime(0)
+    : _lastPassTime(0)
     , _nextPassTime(0)
-    , _inPassWindow(false) {}
+    , _inPassWindow(false)
+    , _passBudgetSpent(false)
+    , _clockLast(0)
+    , _clockWraps(0) {
+#if OUTER_FEC_ENABLED
+    _outerNextGroup = 0;
+    for (uint8_t p = 0; p <= PRIORITY_LOW; p++) {
+        _outer[p].active  = false;
+        _outer[p].closing = false;
+#if PLANNER_ENABLED
+        uint8_t k, m;
+        outerShape(p, k, m);
+        _planner.setParity(p, k, m);
+#endif
+    }
+#endif
+}
 
 void SatelliteGateway::setup() {
     Serial.begin(DEBUG_BAUD);
@@ -61,6 +76,12 @@ void SatelliteGateway::setup() {
         Serial.println("[Gateway] LoRaWAN joined successfully.");
     }
 
+    // Messages queued before a reset or power loss
+    if (_store.begin()) {
+        uint16_t restored = _store.restore(_queue, clockMs());
+        Serial.printf("[Gateway] Restored %d queued messages from storage.\n", restored);
+    }
+
     // Schedule first satellite pass
     _nextPassTime = millis() + SAT_PASS_INTERVAL_MS;
     Serial.printf("[Gateway] Next satellite pass in %d minutes.\n",
@@ -81,7 +102,15 @@ void SatelliteGateway::loop() {
     if (!_inPassWindow && now >= (_nextPassTime - SAT_PASS_WAKE_EARLY_MS)) {
         _inPassWindow = true;
         Serial.println("\n[Gateway] === SATELLITE PASS WINDOW OPEN ===");
-        Serial.printf("[Gateway] Queue: %d messages\n", _queueCount);
+        Serial.printf("[Gateway] Queue: %d messages\n", _queue.count());
+#if PLANNER_ENABLED
+        _passBudgetSpent = false;
+        uint32_t passMs, dutyMs;
+        uplinkBudget(passMs, dutyMs);
+        _planner.next(_queue, _loraWAN, passMs, dutyMs);
+        Serial.printf("[Gateway] Plan: %d messages, %d ms airtime of %d ms left\n",
+            _planner.planned(), (int)_planner.plannedAirtimeMs(), (int)dutyMs);
+#endif
     }
 
     if (_inPassWindow) {
@@ -90,11 +119,14 @@ void SatelliteGateway::loop() {
         // Check if pass window has ended
         if (now >= (_nextPassTime + SAT_PASS_DURATION_MS)) {
             _inPassWindow = false;
+#if OUTER_FEC_ENABLED
+            outerReset();
+#endif
             _lastPassTime = _nextPassTime;
             _nextPassTime = now + SAT_PASS_INTERVAL_MS;
             Serial.println("[Gateway] === SATELLITE PASS WINDOW CLOSED ===");
             Serial.printf("[Gateway] Next pass in %d minutes. Queue: %d remaining.\n",
-                          SAT_PASS_INTERVAL_MS / 60000, _queueCount);
+                          SAT_PASS_INTERVAL_MS / 60000, _queue.count());
         }
     }
 
@@ -107,8 +139,11 @@ void SatelliteGateway::loop() {
     static uint32_t lastMaintenance = 0;
     if (now - lastMaintenance > 60000) {  // Every minute
         purgeExpired();
+        _translator.expireFragments();
+        if (!_inPassWindow) _queue.compact();
         lastMaintenance = now;
     }
+    _store.poll(_queue, clockMs(), !_inPassWindow);
 
     // 5. Status report every 5 minutes
     static uint32_t lastStatus = 0;
@@ -122,15 +157,27 @@ void SatelliteGateway::handleMeshPacket() {
     MeshtasticPacket meshPkt;
     if (!_meshRx.receive(meshPkt)) return;
 
-    // Filter: only relay text messages and MeshXT packets
+    // Filter: only relay text messages, MeshXT packets and position reports
     if (meshPkt.portnum != PORTNUM_TEXT_MESSAGE_APP &&
-        meshPkt.portnum != PORTNUM_PRIVATE_APP) {
+        meshPkt.portnum != PORTNUM_PRIVATE_APP &&
+        !(POSITION_ENABLED && meshPkt.portnum == PORTNUM_POSITION_APP)) {
         if (DEBUG_SERIAL) {
             Serial.printf("[Gateway] Ignoring portnum %d\n", meshPkt.portnum);
         }
         return;
     }
 
+#if DUPLICATE_FILTER_ENABLED
+    // Same packet relayed by another neighbour: already queued or sent
+    if (meshPkt.id != 0 && _seen.seen(meshPkt.source, meshPkt.id, millis())) {
+        if (DEBUG_SERIAL) {
+            Serial.printf("[Gateway] Duplicate 0x%08X from 0x%08X dropped\n",
+                meshPkt.id, meshPkt.source);
+        }
+        return;
+    }
+#endif
+
     // Translate to satellite format
     SatellitePacket satPkt;
     if (!_translator.toSatellite(meshPkt, satPkt)) {
@@ -140,8 +187,12 @@ void SatelliteGateway::handleMeshPacket() {
 
     // Enqueue for next satellite pass
     if (enqueue(satPkt)) {
+#if DUPLICATE_FILTER_ENABLED
+        // Only now: a copy of a packet that failed to queue is still wanted
+        if (meshPkt.id != 0) _seen.record(meshPkt.source, meshPkt.id, millis());
+#endif
         Serial.printf("[Gateway] Queued message from 0x%08X (priority=%d, queue=%d/%d)\n",
-            meshPkt.source, satPkt.priority, _queueCount, QUEUE_MAX_ENTRIES);
+            meshPkt.source, satPkt.priority, _queue.count(), QUEUE_MAX_ENTRIES);
 
         // Blink LED to indicate queued message
         digitalWrite(LED_PIN, LOW);
@@ -153,35 +204,137 @@ void SatelliteGateway::handleMeshPacket() {
 }
 
 void SatelliteGateway::handleSatellitePass() {
-    if (_queueCount == 0) return;
+#if OUTER_FEC_ENABLED
+    // Queue drained: close any part-filled groups so their parity goes out
+    // in this pass rather than waiting for K more frames
+    if (_queue.count() == 0) outerFlush();
+    if (_queue.count() == 0 && !outerParityPending()) return;
+#else
+    if (_queue.count() == 0) return;
+#endif
     if (!_loraWAN.isJoined()) {
         // Try to join during pass
         _loraWAN.join();
         return;
     }
 
-    QueueEntry entry;
-    if (!dequeueHighestPriority(entry)) return;
-
+#if !PLANNER_ENABLED
     // Check duty cycle
     if (!_loraWAN.canTransmit(200)) {  // Estimate ~200ms per packet
         Serial.println("[Gateway] Duty cycle exhausted for this pass.");
         return;
     }
+#endif
+
+#if OUTER_FEC_ENABLED
+    // Parity of a completed group goes out before the next data frame
+    if (sendOuterParity()) {
+        delay(100);
+        return;
+    }
+#endif
+
+#if PLANNER_ENABLED
+    // Planned again before every uplink, from the queue and budget as the
+    // last send left them
+    uint32_t passMs, dutyMs;
+    uplinkBudget(passMs, dutyMs);
+    QueueEntry *entry = _planner.next(_queue, _loraWAN, passMs, dutyMs);
+    if (!entry) {
+#if OUTER_FEC_ENABLED
+        // No more rows this pass: send the parity the budget kept back
+        outerFlush();
+#endif
+        if (!_passBudgetSpent) {
+            Serial.printf("[Gateway] Pass budget spent, %d messages wait for the next pass.\n",
+                _queue.count());
+            _passBudgetSpent = true;
+        }
+        return;
+    }
+    _passBudgetSpent = false;
+    _queue.take(entry);
+#else
+    QueueEntry *entry = _queue.pop();
+    if (!entry) return;
+#endif
+
+    const uint8_t *frame = _queue.payload(entry);
+    uint16_t frameLen = entry->payloadLen;
+    uint8_t  fport = LORAWAN_FPORT;
+    uint16_t room = _loraWAN.maxPayload();
+
+#if OUTER_FEC_ENABLED
+    OuterGroup *group = outerGroupFor(*entry);
+    if (group) room = outerRowLimit();
+#endif
+
+#if CONTAINER_ENABLED
+#if PLANNER_ENABLED
+    // Riders may grow the frame only as far as the budgets left cover
+    uint16_t tagLen = 0;
+#if OUTER_FEC_ENABLED
+    if (group) tagLen = MESHXT_OUTER_DATA_HEADER;
+#endif
+    room = affordableRoom(*entry, room, tagLen);
+#endif
+    // Other queued frames that fit ride along in a container
+    uint8_t container[LORAWAN_MAX_PAYLOAD];
+    QueueEntry *packed[CONTAINER_MAX_RECORDS];
+    uint8_t packedCount = packContainer(*entry, container, room, frameLen, packed);
+    if (packedCount > 0) frame = container;
+#endif
+
+    // What the ground gets back (a relay frame or a container)
+    const uint8_t *row = frame;
+    uint16_t rowLen = frameLen;
+
+#if OUTER_FEC_ENABLED
+    uint8_t tagged[LORAWAN_MAX_PAYLOAD];
+    if (group) {
+        frameLen = meshxt_outer_data_frame(&group->enc, row, rowLen, tagged);
+        frame = tagged;
+        fport = LORAWAN_FPORT_OUTER_DATA;
+    }
+#endif
 
-    // Send via LoRaWAN
-    if (_loraWAN.send(entry.payload, entry.payloadLen, LORAWAN_FPORT)) {
+    // Send via LoRaWAN; a deferral says nothing about the link
+    LoRaWANSendResult result = _loraWAN.send(frame, frameLen, fport);
+    if (result != LORAWAN_DEFERRED) _translator.reportUplink(result == LORAWAN_SENT);
+    bool sent = result == LORAWAN_SENT;
+    if (sent) {
         Serial.printf("[Gateway] Satellite TX OK: %d bytes (retries=%d)\n",
-            entry.payloadLen, entry.retries);
-    } else {
-        // Re-enqueue with incremented retry count if retries remaining
-        if (entry.retries < 3) {
-            entry.retries++;
-            if (_queueCount < QUEUE_MAX_ENTRIES) {
-                _queue[_queueCount++] = entry;
+            frameLen, entry->retries);
+#if OUTER_FEC_ENABLED
+        // Only frames that actually went out become rows of the group; row
+        // may point into the entry's payload, so add it before retiring
+        if (group) {
+            meshxt_outer_add(&group->enc, row, rowLen);
+            if (meshxt_outer_full(&group->enc)) group->closing = true;
+        }
+#endif
+        retire(entry);
+#if CONTAINER_ENABLED
+        if (packedCount > 0) {
+            Serial.printf("[Gateway] Container carried %d more messages.\n", packedCount);
+            for (uint8_t i = 0; i < packedCount; i++) {
+                _store.recordRemove(*packed[i], clockMs());
+                _queue.remove(packed[i]);
             }
+        }
+#endif
+    } else if (result == LORAWAN_DEFERRED) {
+        // Not attempted, so no retry is used; riders are still queued
+        _queue.pushFront(entry);
+    } else {
+        // Back to the front of its priority if retries remain
+        if (entry->retries < 3) {
+            entry->retries++;
+            _queue.pushFront(entry);
+            _store.recordRetry(*entry, clockMs());
         } else {
-            Serial.printf("[Gateway] Message 0x%08X dropped after max retries.\n", entry.id);
+            Serial.printf("[Gateway] Message 0x%08X dropped after max retries.\n", entry->id);
+            retire(entry);
         }
     }
 
@@ -189,15 +342,170 @@ void SatelliteGateway::handleSatellitePass() {
     delay(100);
 }
 
+#if OUTER_FEC_ENABLED
+/**
+ * Open group for the entry's priority, starting one if needed. Returns
+ * NULL when the priority is configured without parity, the payload is
+ * too long to carry the group tag, or (with the planner) the budget left
+ * cannot cover a new group's parity; such frames go out on LORAWAN_FPORT.
+ */
+OuterGroup *SatelliteGateway::outerGroupFor(const QueueEntry &entry) {
+    if (entry.priority > PRIORITY_LOW) return NULL;
+    if (entry.payloadLen > outerRowLimit()) return NULL;
+
+    uint8_t k, m;
+    outerShape(entry.priority, k, m);
+    if (m == 0) return NULL;
+
+    OuterGroup &g = _outer[entry.priority];
+    if (!g.active) {
+#if PLANNER_ENABLED
+        // Start a group only if the frame and all its parity fit what is left
+        uint32_t passMs, dutyMs;
+        uplinkBudget(passMs, dutyMs);
+        uint32_t air = _loraWAN.airtimeMs(entry.payloadLen + MESHXT_OUTER_DATA_HEADER) +
+                       m * _loraWAN.airtimeMs(MESHXT_OUTER_PARITY_HEADER + entry.payloadLen + 1);
+        if (air > dutyMs || air + (m + 1) * PLANNER_TX_GAP_MS > passMs) return NULL;
+#endif
+        if (meshxt_outer_begin(&g.enc, _outerNextGroup, k, m) != 0) return NULL;
+        _outerNextGroup = (_outerNextGroup + 1) & 0x0F;
+        g.active     = true;
+        g.closing    = false;
+        g.paritySent = 0;
+    }
+    return &g;
+}
+
+// Group size K and parity count M configured for a priority
+void SatelliteGateway::outerShape(uint8_t priority, uint8_t &k, uint8_t &m) {
+    switch (priority) {
+        case PRIORITY_EMERGENCY: k = OUTER_FEC_K_EMERGENCY; m = OUTER_FEC_M_EMERGENCY; break;
+        case PRIORITY_HIGH:      k = OUTER_FEC_K_HIGH;      m = OUTER_FEC_M_HIGH;      break;
+        case PRIORITY_NORMAL:    k = OUTER_FEC_K_NORMAL;    m = OUTER_FEC_M_NORMAL;    break;
+        default:                 k = OUTER_FEC_K_LOW;       m = OUTER_FEC_M_LOW;       break;
+    }
+}
+
+/**
+ * Largest payload of a grouped data frame. A parity frame is its header
+ * plus the widest row (length byte + payload), so rows must leave room
+ * for that rather than just the 1-byte data tag.
+ */
+uint16_t SatelliteGateway::outerRowLimit() {
+    uint16_t limit = _loraWAN.maxPayload() - MESHXT_OUTER_PARITY_HEADER - 1;
+    return limit < MESHXT_OUTER_MAX_PAYLOAD ? limit : MESHXT_OUTER_MAX_PAYLOAD;
+}
+
+bool SatelliteGateway::outerParityPending() const {
+    for (uint8_t p = 0; p <= PRIORITY_LOW; p++) {
+        if (_outer[p].active && _outer[p].closing) return true;
+    }
+    return false;
+}
+
+/**
+ * Send the next parity frame of a closed group, highest priority first.
+ * A failed parity send abandons the rest of that group's parity rather
+ * than holding up queued data; the data frames themselves were sent.
+ * Parity the duty cycle left cannot cover is not attempted.
+ *
+ * @return true if a parity frame was attempted
+ */
+bool SatelliteGateway::sendOuterParity() {
+    for (uint8_t p = 0; p <= PRIORITY_LOW; p++) {
+        OuterGroup &g = _outer[p];
+        if (!g.active || !g.closing) continue;
+
+        uint8_t frame[MESHXT_OUTER_PARITY_HEADER + MESHXT_OUTER_MAX_ROW];
+        int len = meshxt_outer_parity_frame(&g.enc, g.paritySent, frame);
+        if (len < 0) {
+            g.active = false;
+            continue;
+        }
+
+        LoRaWANSendResult result = _loraWAN.send(frame, len, LORAWAN_FPORT_OUTER_PARITY);
+        if (result == LORAWAN_DEFERRED) return false;
+        _translator.reportUplink(result == LORAWAN_SENT);
+        bool sent = result == LORAWAN_SENT;
+        if (sent) {
+            Serial.printf("[Gateway] Outer parity %d/%d for group %d (%d frames)\n",
+                g.paritySent + 1, g.enc.m, g.enc.group, g.enc.count);
+            if (++g.paritySent >= g.enc.m) g.active = false;
+        } else {
+            Serial.printf("[Gateway] Outer parity for group %d failed, abandoning.\n", g.enc.group);
+            g.active = false;
+        }
+        return true;
+    }
+    return false;
+}
+
+void SatelliteGateway::outerFlush() {
+    for (uint8_t p = 0; p <= PRIORITY_LOW; p++) {
+        OuterGroup &g = _outer[p];
+        if (!g.active || g.closing) continue;
+        if (g.enc.count == 0) {
+            g.active = false;
+        } else {
+            g.closing = true;
+        }
+    }
+}
+
+void SatelliteGateway::outerReset() {
+    for (uint8_t p = 0; p <= PRIORITY_LOW; p++) {
+        if (_outer[p].active && DEBUG_SERIAL) {
+            Serial.printf("[Gateway] Pass ended with outer group %d incomplete.\n",
+                _outer[p].enc.group);
+        }
+        _outer[p].active  = false;
+        _outer[p].closing = false;
+    }
+}
+#endif
+
 void SatelliteGateway::handleDownlink() {
     DownlinkMessage dl = _loraWAN.getDownlink();
     if (dl.len == 0) return;
 
     Serial.printf("[Gateway] Processing downlink: %d bytes\n", dl.len);
+    _translator.reportDownlinkSnr(dl.snr);
+
+    // Fragment status: queue again only the fragments the ground lacks
+    if (meshxt_fragment_is_status(dl.payload, dl.len)) {
+        uint8_t  msgId;
+        uint16_t missing;
+        uint32_t id;
+        if (!_translator.fragmentStatus(dl.payload, dl.len, msgId, missing, id)) return;
+
+        // Fragments still queued from an earlier status go out anyway
+        missing &= ~queuedFragments(id, msgId);
+
+        uint8_t resent = 0;
+        for (uint8_t i = 0; i < MESHXT_FRAGMENT_MAX; i++) {
+            if ((missing & (1u << i)) && enqueueFragment(id, msgId, i)) resent++;
+        }
+        Serial.printf("[Gateway] Fragment status for id %d: %d to resend.\n", msgId, resent);
+        return;
+    }
+
+    // Downlink fragments wait until the whole frame is in
+    const uint8_t *data = dl.payload;
+    uint16_t len = dl.len;
+    uint8_t  frame[MAX_RELAY_FRAME];
+    if (meshxt_fragment_is(dl.payload, dl.len)) {
+        int rc = _translator.reassemble(dl.payload, dl.len, frame, len);
+        if (rc < 0) {
+            Serial.println("[Gateway] Invalid downlink fragment.");
+            return;
+        }
+        if (rc == 0) return;
+        data = frame;
+    }
 
     // Parse satellite packet
     SatellitePacket satPkt;
-    if (!_translator.fromSatellite(dl.payload, dl.len, satPkt)) {
+    if (!_translator.fromSatellite(data, len, satPkt)) {
         Serial.println("[Gateway] Invalid downlink packet.");
         return;
     }
@@ -219,67 +527,250 @@ void SatelliteGateway::handleDownlink() {
 }
 
 bool SatelliteGateway::enqueue(const SatellitePacket &pkt) {
-    if (_queueCount >= QUEUE_MAX_ENTRIES) return false;
-
-    QueueEntry &entry = _queue[_queueCount];
-    entry.id        = pkt.sourceNode ^ pkt.timestamp;  // Simple unique ID
-    entry.priority  = pkt.priority;
-    entry.timestamp = millis();
-    entry.ttl       = ttlForPriority(pkt.priority);
-    entry.retries   = 0;
+    uint8_t  frame[MAX_RELAY_FRAME];
+    uint16_t frameLen;
+    if (!_translator.serialize(pkt, frame, frameLen)) return false;
+
+    uint32_t id = pkt.sourceNode ^ pkt.timestamp;  // Simple unique ID
+    uint16_t limit = uplinkLimit(pkt.priority);
+
+    if (frameLen <= limit) {
+        QueueEntry *entry = newEntry(id, pkt.priority, frameLen);
+        if (!entry) return false;
+        memcpy(_queue.payload(entry), frame, frameLen);
+        commit(entry);
+        return true;
+    }
 
-    // Serialize the satellite packet
-    _translator.serialize(pkt, entry.payload, entry.payloadLen);
+    // Too large for one uplink at this data rate: queue it as fragments
+    int n = meshxt_fragment_count(frameLen, limit);
+    if (n < 0 || _queue.count() + n > QUEUE_MAX_ENTRIES) return false;
+    if (_queue.arenaFree() < frameLen + n * (QUEUE_ARENA_HEADER + MESHXT_FRAGMENT_HEADER)) {
+        return false;
+    }
 
-    _queueCount++;
+    uint8_t msgId, count;
+    if (!_translator.holdFragments(frame, frameLen, limit, pkt.priority, id, msgId, count)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        enqueueFragment(id, msgId, i);
+    }
+    if (DEBUG_SERIAL) {
+        Serial.printf("[Gateway] %d-byte frame split into %d fragments (id %d)\n",
+            frameLen, count, msgId);
+    }
     return true;
 }
 
-bool SatelliteGateway::dequeueHighestPriority(QueueEntry &entry) {
-    if (_queueCount == 0) return false;
+/**
+ * Free queue slot with payloadLen bytes reserved and its bookkeeping
+ * filled in. The caller copies in the payload and then queues it with
+ * commit(). NULL if the queue or its payload arena is full.
+ */
+QueueEntry *SatelliteGateway::newEntry(uint32_t id, uint8_t priority, uint16_t payloadLen) {
+    QueueEntry *entry = _queue.alloc(payloadLen);
+    if (!entry) return NULL;
+
+    entry->id       = id;
+    entry->priority = priority;
+    entry->retries  = 0;
+    setTtl(entry, ttlForPriority(priority));
+    return entry;
+}
+
+bool SatelliteGateway::enqueueFragment(uint32_t id, uint8_t msgId, uint8_t index) {
+    uint8_t  frag[MAX_SATELLITE_PAYLOAD];
+    uint16_t fragLen;
+    uint8_t  priority;
+    if (!_translator.buildFragment(msgId, index, frag, fragLen, priority)) return false;
+
+    QueueEntry *entry = newEntry(id, priority, fragLen);
+    if (!entry) return false;
+    memcpy(_queue.payload(entry), frag, fragLen);
+    commit(entry);
+    return true;
+}
 
-    // Find highest priority (lowest number)
-    uint8_t bestIdx = 0;
-    uint8_t bestPriority = 255;
-    for (uint8_t i = 0; i < _queueCount; i++) {
-        if (_queue[i].priority < bestPriority) {
-            bestPriority = _queue[i].priority;
-            bestIdx = i;
+/**
+ * Bitmap of the fragments of message msgId (queue id id) still queued.
+ */
+uint16_t SatelliteGateway::queuedFragments(uint32_t id, uint8_t msgId) {
+    uint16_t queued = 0;
+    for (uint8_t p = PRIORITY_EMERGENCY; p <= PRIORITY_LOW; p++) {
+        for (QueueEntry *e = _queue.first(p); e; e = _queue.next(e)) {
+            const uint8_t *f = _queue.payload(e);
+            if (e->id != id || !meshxt_fragment_is(f, e->payloadLen)) continue;
+            if (f[1] == msgId) queued |= (uint16_t)(1u << (f[2] >> 4));
         }
     }
+    return queued;
+}
 
-    entry = _queue[bestIdx];
+/**
+ * Queue a filled entry and log it to the persistent store.
+ */
+void SatelliteGateway::commit(QueueEntry *entry) {
+    _queue.push(entry);
+    _store.recordAdd(*entry, _queue.payload(entry), clockMs());
+}
 
-    // Remove from queue (shift remaining)
-    for (uint8_t i = bestIdx; i < _queueCount - 1; i++) {
-        _queue[i] = _queue[i + 1];
-    }
-    _queueCount--;
+/**
+ * Free a popped or expired entry for good, logging its removal.
+ */
+void SatelliteGateway::retire(QueueEntry *entry) {
+    _store.recordRemove(*entry, clockMs());
+    _queue.release(entry);
+}
 
-    return true;
+/**
+ * Largest relay frame of this priority sent as a single uplink at the
+ * configured data rate. With outer parity it must fit a group row, whose
+ * parity frame is the longest. Larger frames are fragmented.
+ */
+uint16_t SatelliteGateway::uplinkLimit(uint8_t priority) {
+    uint16_t limit = _loraWAN.maxPayload();
+#if OUTER_FEC_ENABLED
+    uint8_t k, m;
+    outerShape(priority, k, m);
+    if (m > 0) limit = outerRowLimit();
+#else
+    (void)priority;
+#endif
+    if (limit > MAX_SATELLITE_PAYLOAD) limit = MAX_SATELLITE_PAYLOAD;
+    return limit;
 }
 
-void SatelliteGateway::purgeExpired() {
-    uint32_t now = millis();
-    uint8_t purged = 0;
-
-    for (int i = _queueCount - 1; i >= 0; i--) {
-        uint32_t age = (now - _queue[i].timestamp) / 1000;
-        if (age > _queue[i].ttl) {
-            // Remove expired entry
-            for (uint8_t j = i; j < _queueCount - 1; j++) {
-                _queue[j] = _queue[j + 1];
+#if CONTAINER_ENABLED
+static_assert(MESHXT_RELAY_FRAME_HEADER == RELAY_HEADER_SIZE,
+              "MeshXTContainer must know the relay header layout");
+
+/**
+ * Build a container of head plus other queued frames, highest priority
+ * first, within room bytes. Returns how many queued frames were packed
+ * (they go to packed and stay queued until the uplink succeeds), or 0 if
+ * nothing else fits and head should go out alone.
+ */
+uint8_t SatelliteGateway::packContainer(const QueueEntry &head, uint8_t *out, uint16_t room,
+                                        uint16_t &outLen, QueueEntry **packed) {
+    MeshXTContainer c;
+    meshxt_container_begin(&c, out, room);
+    if (meshxt_container_add(&c, _queue.payload(&head), head.payloadLen) != 0) return 0;
+
+    uint8_t count = 0;
+    for (uint8_t p = PRIORITY_EMERGENCY; p <= PRIORITY_LOW; p++) {
+        for (QueueEntry *e = _queue.first(p); e && count < CONTAINER_MAX_RECORDS - 1;
+             e = _queue.next(e)) {
+            if (meshxt_container_add(&c, _queue.payload(e), e->payloadLen) == 0) {
+                packed[count++] = e;
             }
-            _queueCount--;
-            purged++;
         }
     }
 
+    // A lone record is larger than the plain relay frame
+    if (count == 0) return 0;
+    outLen = (uint16_t)c.len;
+    return count;
+}
+
+#if PLANNER_ENABLED
+/**
+ * Largest container, down to the head's own frame, whose airtime the
+ * budgets left after the plan's reserve still cover. A grouped container
+ * also widens its group's parity frames, so that growth must fit too.
+ */
+uint16_t SatelliteGateway::affordableRoom(const QueueEntry &head, uint16_t room, uint16_t tagLen) {
+    uint32_t passMs, dutyMs;
+    uplinkBudget(passMs, dutyMs);
+
+    for (; room > head.payloadLen; room--) {
+        uint32_t air = _loraWAN.airtimeMs(room + tagLen);
+        uint32_t pass = air + PLANNER_TX_GAP_MS;
+#if OUTER_FEC_ENABLED
+        const OuterGroup &g = _outer[head.priority];
+        if (tagLen > 0 && g.active && room + 1 > g.enc.width) {
+            uint32_t frames = g.enc.m - g.paritySent;
+            uint32_t wider = _loraWAN.airtimeMs(MESHXT_OUTER_PARITY_HEADER + room + 1);
+            uint32_t now = _loraWAN.airtimeMs(MESHXT_OUTER_PARITY_HEADER + g.enc.width);
+            air += frames * (wider - now);
+            pass += frames * (wider - now);
+        }
+#endif
+        if (air <= dutyMs && pass <= passMs) break;
+    }
+    return room;
+}
+#endif
+#endif
+
+/**
+ * Drop entries past their TTL. The queue's expiry heap hands out only the
+ * entries that are due, so the cost does not grow with queue depth.
+ */
+void SatelliteGateway::purgeExpired() {
+    uint32_t now = (uint32_t)(clockMs() / 1000);
+    uint16_t purged = 0;
+
+    QueueEntry *e;
+    while ((e = _queue.popExpired(now)) != NULL) {
+        retire(e);
+        purged++;
+    }
+
     if (purged > 0 && DEBUG_SERIAL) {
         Serial.printf("[Gateway] Purged %d expired messages.\n", purged);
     }
 }
 
+/**
+ * Set an unqueued entry's TTL (seconds), counted from now.
+ */
+void SatelliteGateway::setTtl(QueueEntry *entry, uint32_t ttl) {
+    entry->expires = (uint32_t)(clockMs() / 1000) + ttl;
+}
+
+/**
+ * Milliseconds since boot without the 32-bit wrap. Must be called at
+ * least once per ~49 days to see each wrap; maintenance calls it every
+ * minute.
+ */
+uint64_t SatelliteGateway::clockMs() {
+    uint32_t now = millis();
+    if (now < _clockLast) _clockWraps++;
+    _clockLast = now;
+    return ((uint64_t)_clockWraps << 32) | now;
+}
+
+// Milliseconds until the current pass window closes
+uint32_t SatelliteGateway::passTimeLeft() {
+    uint32_t end = _nextPassTime + SAT_PASS_DURATION_MS;
+    uint32_t now = millis();
+    return end > now ? end - now : 0;
+}
+
+#if PLANNER_ENABLED
+/**
+ * Pass time and duty cycle left for data frames. Parity still owed by open
+ * outer groups comes off both first: every parity frame a group has yet to
+ * send, at the group's current width, with its PLANNER_TX_GAP_MS.
+ */
+void SatelliteGateway::uplinkBudget(uint32_t &passMs, uint32_t &dutyMs) {
+    passMs = passTimeLeft();
+    dutyMs = _loraWAN.getAirtimeRemainingMs();
+#if OUTER_FEC_ENABLED
+    for (uint8_t p = 0; p <= PRIORITY_LOW; p++) {
+        const OuterGroup &g = _outer[p];
+        if (!g.active || g.paritySent >= g.enc.m) continue;
+        uint32_t frames = g.enc.m - g.paritySent;
+        uint32_t air = frames * _loraWAN.airtimeMs(MESHXT_OUTER_PARITY_HEADER + g.enc.width);
+        uint32_t pass = air + frames * PLANNER_TX_GAP_MS;
+        dutyMs = dutyMs > air ? dutyMs - air : 0;
+        passMs = passMs > pass ? passMs - pass : 0;
+    }
+#endif
+}
+#endif
+
 uint32_t SatelliteGateway::ttlForPriority(uint8_t priority) {
     switch (priority) {
         case PRIORITY_EMERGENCY: return TTL_EMERGENCY;
@@ -292,7 +783,11 @@ uint32_t SatelliteGateway::ttlForPriority(uint8_t priority) {
 
 void SatelliteGateway::printStatus() {
     Serial.println("\n--- MeshXT-Satellite Status ---");
-    Serial.printf("  Queue:     %d/%d messages\n", _queueCount, QUEUE_MAX_ENTRIES);
+    Serial.printf("  Queue:     %d/%d messages, %d/%d payload bytes\n", _queue.count(),
+                  QUEUE_MAX_ENTRIES, QUEUE_ARENA_BYTES - _queue.arenaFree(), QUEUE_ARENA_BYTES);
+#if DUPLICATE_FILTER_ENABLED
+    Serial.printf("  Dupes:     %d dropped\n", _seen.suppressed());
+#endif
     Serial.printf("  LoRaWAN:   %s\n", _loraWAN.isJoined() ? "Joined" : "Not joined");
     Serial.printf("  Airtime:   %dms / %dms used\n",
                   _loraWAN.getAirtimeUsedMs(), DUTY_CYCLE_LIMIT_MS);
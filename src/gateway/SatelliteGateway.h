@@ -9,16 +9,20 @@
 #include "MeshtasticReceiver.h"
 #include "LoRaWANTransmitter.h"
 #include "PacketTranslator.h"
+#include "MessageQueue.h"
+#include "DuplicateFilter.h"
+#include "QueueStore.h"
+#include "PassPlanner.h"
 #include "config.h"
+#include "../meshxt/MeshXTOuterFEC.h"
+#include "../meshxt/MeshXTContainer.h"
 
-struct QueueEntry {
-    uint32_t id;
-    uint8_t  priority;
-    uint32_t timestamp;
-    uint32_t ttl;
-    uint8_t  retries;
-    uint16_t payloadLen;
-    uint8_t  payload[MAX_SATELLITE_PAYLOAD];
+// Outer FEC group being sent for one priority level
+struct OuterGroup {
+    MeshXTOuterEncoder enc;
+    bool    active;         // Group started (rows being added or parity pending)
+    bool    closing;        // No more rows; parity frames being sent
+    uint8_t paritySent;
 };
 
 class SatelliteGateway {
@@ -33,24 +37,71 @@ private:
     LoRaWANTransmitter  _loraWAN;
     PacketTranslator    _translator;
 
-    QueueEntry _queue[QUEUE_MAX_ENTRIES];
-    uint8_t    _queueCount;
+    MessageQueue _queue;
+    QueueStore   _store;
+#if PLANNER_ENABLED
+    PassPlanner  _planner;
+#endif
+#if DUPLICATE_FILTER_ENABLED
+    DuplicateFilter _seen;
+#endif
 
     uint32_t _lastPassTime;
     uint32_t _nextPassTime;
     bool     _inPassWindow;
+    bool     _passBudgetSpent;
+
+    // millis() extended past its ~49-day wrap
+    uint32_t _clockLast;
+    uint32_t _clockWraps;
+
+#if OUTER_FEC_ENABLED
+    OuterGroup _outer[PRIORITY_LOW + 1];
+    uint8_t    _outerNextGroup;
+#endif
 
     // Core operations
     void handleMeshPacket();
     void handleSatellitePass();
     void handleDownlink();
     void updatePassSchedule();
+    uint32_t passTimeLeft();
+#if PLANNER_ENABLED
+    void uplinkBudget(uint32_t &passMs, uint32_t &dutyMs);
+#endif
+    uint64_t clockMs();
 
     // Queue management
     bool enqueue(const SatellitePacket &pkt);
-    bool dequeueHighestPriority(QueueEntry &entry);
+    QueueEntry *newEntry(uint32_t id, uint8_t priority, uint16_t payloadLen);
+    bool enqueueFragment(uint32_t id, uint8_t msgId, uint8_t index);
+    uint16_t queuedFragments(uint32_t id, uint8_t msgId);
+    void commit(QueueEntry *entry);
+    void retire(QueueEntry *entry);
+    uint16_t uplinkLimit(uint8_t priority);
     void purgeExpired();
     uint32_t ttlForPriority(uint8_t priority);
+    void setTtl(QueueEntry *entry, uint32_t ttl);
+
+#if CONTAINER_ENABLED
+    // Frame aggregation
+    uint8_t packContainer(const QueueEntry &head, uint8_t *out, uint16_t room,
+                          uint16_t &outLen, QueueEntry **packed);
+#if PLANNER_ENABLED
+    uint16_t affordableRoom(const QueueEntry &head, uint16_t room, uint16_t tagLen);
+#endif
+#endif
+
+#if OUTER_FEC_ENABLED
+    // Outer FEC (parity frames across a pass)
+    OuterGroup *outerGroupFor(const QueueEntry &entry);
+    static void outerShape(uint8_t priority, uint8_t &k, uint8_t &m);
+    uint16_t outerRowLimit();
+    bool outerParityPending() const;
+    bool sendOuterParity();
+    void outerFlush();
+    void outerReset();
+#endif
 
     // Status
     void printStatus();
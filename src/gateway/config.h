@@ -37,6 +37,8 @@
 #define LORAWAN_SF            9        // Spreading factor (7-12)
 #define LORAWAN_TX_POWER      14       // dBm
 #define LORAWAN_FPORT         42       // Application port for MeshXT relay
+#define LORAWAN_FPORT_OUTER_DATA    43 // Relay frames inside an outer FEC group
+#define LORAWAN_FPORT_OUTER_PARITY  44 // Outer FEC parity frames
 
 // Duty cycle (EU868: 1% = 36000ms per hour)
 #define DUTY_CYCLE_LIMIT_MS   36000
@@ -101,11 +103,24 @@
 #define SAT_PASS_WAKE_EARLY_MS  60000    // Wake 60s before predicted pass
 #define SAT_USE_TLE             false    // Use TLE prediction (requires GPS + time)
 
+// Pass planning: each uplink is taken from the most valuable set of queued
+// frames whose airtime fits both the pass time and the duty cycle left
+// (PassPlanner.h), planned again after every send
+#define PLANNER_ENABLED         true
+#define PLANNER_VALUE_EMERGENCY 1000     // Value of one frame per priority
+#define PLANNER_VALUE_HIGH      100
+#define PLANNER_VALUE_NORMAL    10
+#define PLANNER_VALUE_LOW       1
+#define PLANNER_TX_GAP_MS       2100     // Pass time per uplink besides airtime (RX windows, spacing)
+#define PLANNER_MAX_ITEMS       64       // Frames considered per plan, in send order
+#define PLANNER_QUANTA          256      // Budget steps in the knapsack table
+
 // ============================================================
 // Message Queue
 // ============================================================
-#define QUEUE_MAX_ENTRIES       64
+#define QUEUE_MAX_ENTRIES       180      // Entry pool size (< 65535), 26 bytes each
 #define QUEUE_MAX_PAYLOAD       128      // Max bytes per satellite payload
+#define QUEUE_ARENA_BYTES       6144     // Shared payload storage, 4 bytes overhead per message
 
 // TTL defaults (seconds)
 #define TTL_EMERGENCY           86400    // 24 hours
@@ -113,12 +128,106 @@
 #define TTL_NORMAL              21600    // 6 hours
 #define TTL_LOW                 7200     // 2 hours
 
+// Persistence: queue changes are logged to flash (ESP32 LittleFS) or a
+// file (Linux) and replayed on boot. Other targets keep the queue in RAM.
+#define STORE_ENABLED           true
+#if defined(ESP32)
+#define STORE_PATH              "/littlefs/meshxt-queue.log"
+#else
+#define STORE_PATH              "meshxt-queue.log"
+#endif
+#define STORE_BUFFER_BYTES      512      // Records batched in RAM between writes
+#define STORE_FLUSH_MS          5000     // Max delay before a batch is written
+#define STORE_COMPACT_BYTES     32768    // Rewrite the log between passes past this size
+#define STORE_COMPACT_RETRY_MS  1800000  // Wait after a failed rewrite (full flash, say)
+#define STORE_CLOCK_MS          300000   // Age checkpoint while messages are queued
+
+// ============================================================
+// Duplicate Suppression
+// ============================================================
+// Mesh rebroadcasts of a packet already queued are dropped at ingest,
+// keyed on (source, packet id)
+#define DUPLICATE_FILTER_ENABLED    true
+#define DUPLICATE_FILTER_SLOTS      256      // Seen-set size (power of two), 12 bytes each
+#define DUPLICATE_FILTER_PROBE      8        // Slots searched per lookup
+#define DUPLICATE_WINDOW_MS         600000   // A copy heard within 10 minutes is a duplicate
+
 // ============================================================
 // MeshXT Compression / FEC
 // ============================================================
 #define MESHXT_COMPRESSION_ENABLED  true
 #define MESHXT_FEC_ENABLED          true
-#define MESHXT_FEC_REDUNDANCY       4    // Reed-Solomon parity symbols
+#define MESHXT_FEC_REDUNDANCY       16   // RS parity symbols when not adaptive (16, 32 or 64)
+
+// Adaptive FEC: pick none/LOW/MEDIUM/HIGH per packet from recent link
+// statistics. Level codes: 0 = none, 1 = LOW(16), 2 = MEDIUM(32), 3 = HIGH(64)
+#define MESHXT_FEC_ADAPTIVE         true
+#define FEC_ADAPT_HISTORY           16       // Uplink results remembered (<= 32)
+#define FEC_ADAPT_DEFAULT_LEVEL     1        // Until there are statistics
+#define FEC_ADAPT_SNR_GOOD          0.0f     // dB; at or above: no parity needed
+#define FEC_ADAPT_SNR_FAIR          -7.0f    // dB; below: MEDIUM
+#define FEC_ADAPT_SNR_POOR          -12.0f   // dB; below: HIGH
+#define FEC_ADAPT_LOSS_FAIR         10       // % failed uplink transmissions; above: MEDIUM
+#define FEC_ADAPT_LOSS_POOR         25       // % failed uplinks; above: HIGH
+
+// Minimum level per priority (SOS always gets at least MEDIUM)
+#define FEC_FLOOR_EMERGENCY         2
+#define FEC_FLOOR_HIGH              1
+#define FEC_FLOOR_NORMAL            0
+#define FEC_FLOOR_LOW               0
+
+// Outer FEC: after every K data frames of a priority, send M parity frames
+// so the ground can rebuild up to M frames lost from that group.
+// M = 0 sends that priority unprotected. K <= 16, M <= MESHXT_OUTER_MAX_PARITY (4).
+#define OUTER_FEC_ENABLED           true
+#define OUTER_FEC_K_EMERGENCY       4
+#define OUTER_FEC_M_EMERGENCY       2
+#define OUTER_FEC_K_HIGH            6
+#define OUTER_FEC_M_HIGH            2
+#define OUTER_FEC_K_NORMAL          10
+#define OUTER_FEC_M_NORMAL          2
+#define OUTER_FEC_K_LOW             12
+#define OUTER_FEC_M_LOW             0
+
+// ============================================================
+// Relay Header
+// ============================================================
+// v2 compact header (docs/PROTOCOL.md): senders as indices into a node
+// table, minute timestamps. false sends the 14-byte v1 header.
+#define RELAY_COMPACT_HEADER        true
+#define RELAY_NODE_SLOTS            32       // Node table size (same on the ground)
+#define RELAY_NODE_ANNOUNCE         3        // Frames with the full ID after a node gets a slot
+#define RELAY_NODE_REANNOUNCE       16       // Then every Nth frame (0 = never)
+
+// ============================================================
+// Frame Aggregation
+// ============================================================
+// Pack other queued relay frames into the same uplink as the one being
+// sent (MeshXTContainer.h), up to the data rate's payload limit
+#define CONTAINER_ENABLED           true
+#define CONTAINER_MAX_RECORDS       8        // Relay frames per uplink
+
+// ============================================================
+// Fragmentation
+// ============================================================
+// Relay frames larger than one uplink are sent as fragments
+// (MeshXTFragment.h); the ground's status downlink names the missing ones
+#define FRAGMENT_TX_SLOTS           4        // Fragmented messages held for resends
+#define FRAGMENT_TX_HOLD_MS         (2 * SAT_PASS_INTERVAL_MS)
+#define FRAGMENT_RX_SLOTS           2        // Downlink messages being reassembled
+#define FRAGMENT_RX_TIMEOUT_MS      (2 * SAT_PASS_INTERVAL_MS)
+
+// ============================================================
+// Position Reports
+// ============================================================
+// PORTNUM_POSITION_APP fixes are quantized and delta coded against the
+// previous report of the same node (MESHXT_MODE_POSITION)
+#define POSITION_ENABLED            true
+#define POSITION_STEP_LATLON        100      // 1e-7 deg (100 = about 1.1 m)
+#define POSITION_STEP_ALT           5        // Metres
+#define POSITION_STEP_TIME          15       // Seconds
+#define POSITION_KEYFRAME_EVERY     8        // Deltas between absolute reports
+#define POSITION_TRACK_NODES        16       // Nodes with delta state (LRU)
 
 // ============================================================
 // Debug
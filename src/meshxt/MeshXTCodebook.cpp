@@ -0,0 +1,178 @@
+#include "MeshXTCodebook.h"
+#include "MeshXTCodebookTable.h"
+#include "MeshXTSeq.h"
+#include <string.h>
+
+namespace {
+
+struct CodebookEntry {
+    const char *str;
+    uint8_t     len;
+};
+
+#define CB(s) { s, sizeof(s) - 1 }
+
+// Code = position in the generated list (MeshXTCodebookTable.h), which
+// tools/gen_codebook.py sorts by first byte, longest first within a byte:
+// the first hit in a byte's bucket is the longest match.
+constexpr CodebookEntry codebook[] = { MESHXT_CODEBOOK_ENTRIES };
+
+#undef CB
+
+constexpr int codebookSize = sizeof(codebook) / sizeof(codebook[0]);
+
+// ------------------------------------------------------------
+// Compile-time index and validation
+// ------------------------------------------------------------
+
+constexpr uint8_t cb_first(int i) {
+    return (uint8_t)codebook[i].str[0];
+}
+
+constexpr bool cb_entry_ok(int i) {
+    return codebook[i].len > 0 && codebook[i].len <= 16 &&
+           (i == 0 ||
+            cb_first(i - 1) < cb_first(i) ||
+            (cb_first(i - 1) == cb_first(i) && codebook[i - 1].len >= codebook[i].len));
+}
+
+constexpr bool cb_valid(int lo, int hi) {
+    return hi - lo == 0 ? true
+         : hi - lo == 1 ? cb_entry_ok(lo)
+         : cb_valid(lo, (lo + hi) / 2) && cb_valid((lo + hi) / 2, hi);
+}
+
+static_assert(codebookSize == MESHXT_CODEBOOK_SIZE, "codebook must fill codes 0x00-0xFD");
+static_assert(cb_valid(0, codebookSize),
+              "codebook must be sorted by first byte then longest first, entries 1-16 bytes; "
+              "rerun tools/gen_codebook.py");
+
+// First entry whose string starts at or after byte c
+constexpr int cb_lower_bound(int c, int lo, int hi) {
+    return lo >= hi ? lo
+         : cb_first((lo + hi) / 2) < c ? cb_lower_bound(c, (lo + hi) / 2 + 1, hi)
+         : cb_lower_bound(c, lo, (lo + hi) / 2);
+}
+
+struct CodebookIndex {
+    uint8_t bucket[257];    // Entries starting with byte b are [bucket[b], bucket[b + 1])
+};
+
+template<int... B>
+constexpr CodebookIndex cb_build_index(MeshXTSeq<B...>) {
+    return CodebookIndex{ { (uint8_t)cb_lower_bound(B, 0, codebookSize)... } };
+}
+
+constexpr CodebookIndex codebookIndex = cb_build_index(MeshXTMakeSeq<257>::type());
+
+// Emit pending verbatim bytes (or just count them if out is NULL);
+// false if out of space
+bool flush_verbatim(const uint8_t *lit, size_t litLen, uint8_t *out, size_t &o, size_t outCap) {
+    if (litLen == 0) return true;
+    size_t need = (litLen == 1 ? 1 : 2) + litLen;
+    if (o + need > outCap) return false;
+
+    if (!out) {
+        o += need;
+        return true;
+    }
+
+    if (litLen == 1) {
+        out[o++] = MESHXT_CODEBOOK_VERBATIM;
+    } else {
+        out[o++] = MESHXT_CODEBOOK_RUN;
+        out[o++] = (uint8_t)(litLen - 1);
+    }
+    memcpy(out + o, lit, litLen);
+    o += litLen;
+    return true;
+}
+
+} // namespace
+
+int meshxt_compress(const char *message, uint8_t *out, size_t outCap) {
+    return meshxt_compress_bytes((const uint8_t *)message, strlen(message), out, outCap);
+}
+
+int meshxt_compress_bytes(const uint8_t *in, size_t inLen, uint8_t *out, size_t outCap) {
+    size_t o = 0;
+    size_t i = 0;
+    size_t litStart = 0;
+    size_t litLen = 0;
+
+    while (i < inLen) {
+        uint8_t b = in[i];
+        size_t remaining = inLen - i;
+        int hit = -1;
+
+        for (int d = codebookIndex.bucket[b]; d < codebookIndex.bucket[b + 1]; d++) {
+            const CodebookEntry &e = codebook[d];
+            if (e.len <= remaining && memcmp(in + i, e.str, e.len) == 0) {
+                hit = d;
+                break;
+            }
+        }
+
+        if (hit < 0) {
+            if (litLen == 0) litStart = i;
+            litLen++;
+            i++;
+            if (litLen == 256) {
+                if (!flush_verbatim(in + litStart, litLen, out, o, outCap)) return -1;
+                litLen = 0;
+            }
+            continue;
+        }
+
+        if (!flush_verbatim(in + litStart, litLen, out, o, outCap)) return -1;
+        litLen = 0;
+        if (o >= outCap) return -1;
+        if (out) out[o] = (uint8_t)hit;
+        o++;
+        i += codebook[hit].len;
+    }
+
+    if (!flush_verbatim(in + litStart, litLen, out, o, outCap)) return -1;
+    return (int)o;
+}
+
+int meshxt_decompress_bytes(const uint8_t *in, size_t inLen, uint8_t *out, size_t outCap) {
+    size_t o = 0;
+    size_t i = 0;
+    while (i < inLen) {
+        uint8_t b = in[i++];
+        const uint8_t *src;
+        size_t len;
+
+        if (b == MESHXT_CODEBOOK_VERBATIM) {
+            if (i >= inLen) return -1;
+            src = in + i;
+            len = 1;
+            i += 1;
+        } else if (b == MESHXT_CODEBOOK_RUN) {
+            if (i >= inLen) return -1;
+            len = (size_t)in[i++] + 1;
+            if (len > inLen - i) return -1;
+            src = in + i;
+            i += len;
+        } else {
+            src = (const uint8_t *)codebook[b].str;
+            len = codebook[b].len;
+        }
+
+        if (len > outCap - o) return -1;
+        memcpy(out + o, src, len);
+        o += len;
+    }
+    return (int)o;
+}
+
+int meshxt_decompress(const uint8_t *in, size_t inLen, char *out, size_t outCap) {
+    if (outCap == 0) return -1;
+
+    // Keep one byte for the terminator
+    int n = meshxt_decompress_bytes(in, inLen, (uint8_t *)out, outCap - 1);
+    if (n < 0) return -1;
+    out[n] = '\0';
+    return n;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * MeshXT short-string codebook compression (SMAZ-style)
+ *
+ * Each output byte is either a code for one of 254 common substrings
+ * (trained on mesh chat by tools/gen_codebook.py into
+ * MeshXTCodebookTable.h) or an escape for bytes the codebook does not
+ * cover:
+ *
+ *   0x00 - 0xFD   Codebook entry
+ *   0xFE b        One verbatim byte
+ *   0xFF n b...   n + 1 verbatim bytes (1 - 256)
+ *
+ * The encoder takes the longest codebook match at each position, so
+ * typical chat text shrinks to roughly half its length; arbitrary binary
+ * grows by at most 2 bytes per 256.
+ */
+
+#define MESHXT_CODEBOOK_SIZE      254
+#define MESHXT_CODEBOOK_VERBATIM  0xFE
+#define MESHXT_CODEBOOK_RUN       0xFF
+
+/**
+ * Compress a text message.
+ *
+ * @param message  Input text (null-terminated)
+ * @param out      Output buffer
+ * @param outCap   Capacity of out in bytes
+ * @return         Compressed length, or -1 if it does not fit outCap
+ */
+int meshxt_compress(const char *message, uint8_t *out, size_t outCap);
+
+/**
+ * Compress a byte buffer (may contain NUL bytes).
+ *
+ * With out == NULL nothing is written and the return value is the size
+ * the output would have, so callers can compare codecs cheaply; outCap
+ * still applies and stops the scan as soon as the output would exceed it.
+ *
+ * @return  Compressed length, or -1 if it does not fit outCap
+ */
+int meshxt_compress_bytes(const uint8_t *in, size_t inLen, uint8_t *out, size_t outCap);
+
+/**
+ * Decompress to a null-terminated string.
+ *
+ * @param in      Compressed bytes
+ * @param inLen   Compressed length
+ * @param out     Output buffer
+ * @param outCap  Capacity of out, including the terminator
+ * @return        Message length (excluding the terminator), or -1 on
+ *                truncated input or if the message does not fit
+ */
+int meshxt_decompress(const uint8_t *in, size_t inLen, char *out, size_t outCap);
+
+/**
+ * Decompress to a byte buffer (no terminator).
+ *
+ * @return  Decoded length, or -1 on truncated input or if the output
+ *          does not fit outCap
+ */
+int meshxt_decompress_bytes(const uint8_t *in, size_t inLen, uint8_t *out, size_t outCap);
@@ -0,0 +1,40 @@
+#pragma once
+
+// Generated by tools/gen_codebook.py from tools/corpus/mesh_chat.txt — do not edit.
+// Expected size on the corpus: 52.8% of the input.
+
+#define MESHXT_CODEBOOK_VERSION 1
+
+// Code = position in this list; CB() is defined by MeshXTCodebook.cpp
+#define MESHXT_CODEBOOK_ENTRIES \
+    CB(" at the "), CB(" on the "), CB(" again"), CB(" camp "), CB(" the r"), CB(" the s"), \
+    CB(" the t"), CB(" trail"), CB(" water"), CB(" and "), CB(" for "), CB(" the "), \
+    CB(" you "), CB(" all"), CB(" at "), CB(" in "), CB(" is "), CB(" min"), CB(" to "), \
+    CB(" we "), CB(" you"), CB(" ba"), CB(" ch"), CB(" co"), CB(" do"), CB(" fi"), CB(" go"), \
+    CB(" km"), CB(" me"), CB(" ne"), CB(" no"), CB(" of"), CB(" on"), CB(" pa"), CB(" re"), \
+    CB(" sa"), CB(" up"), CB(" 2"), CB(" 3"), CB(" 4"), CB(" c"), CB(" f"), CB(" h"), CB(" l"), \
+    CB(" s"), CB(" "), CB("!"), CB("'"), CB(", all "), CB(", s"), CB(", t"), CB(", w"), \
+    CB(", "), CB("-"), CB("."), CB("0 m"), CB("0"), CB("12"), CB("1"), CB("2 "), CB("20"), \
+    CB("2"), CB("3"), CB("4"), CB("5"), CB("6"), CB("7"), CB("8"), CB(":"), CB("?"), CB("A"), \
+    CB("B"), CB("C"), CB("E"), CB("F"), CB("G"), CB("H"), CB("I"), CB("L"), CB("Me"), CB("N"), \
+    CB("O"), CB("P"), CB("R"), CB("S"), CB("Te"), CB("T"), CB("W"), CB("atter"), CB("ater"), \
+    CB("ack"), CB("am "), CB("ar "), CB("are"), CB("ase"), CB("ast"), CB("ate"), CB("ay "), \
+    CB("ai"), CB("al"), CB("an"), CB("ar"), CB("as"), CB("ay"), CB("a"), CB("b"), CB("cking"), \
+    CB("camp"), CB("che"), CB("ck "), CB("ce"), CB("co"), CB("c"), CB("d a"), CB("de "), \
+    CB("dge"), CB("d "), CB("d"), CB("e are "), CB("ed a"), CB("eed "), CB("e a"), CB("e n"), \
+    CB("e p"), CB("e s"), CB("e t"), CB("e w"), CB("ead"), CB("eam"), CB("ed "), CB("ee "), \
+    CB("ell"), CB("er "), CB("e "), CB("ea"), CB("ec"), CB("el"), CB("en"), CB("er"), CB("es"), \
+    CB("et"), CB("e"), CB("for"), CB("fe"), CB("f"), CB("ge "), CB("ga"), CB("ge"), CB("g"), \
+    CB("hanks"), CB("he ri"), CB("heck"), CB("here"), CB("han"), CB("ha"), CB("hi"), CB("h"), \
+    CB("ing "), CB("igh"), CB("ill"), CB("ine"), CB("iti"), CB("ive"), CB("ic"), CB("in"), \
+    CB("is"), CB("it"), CB("i"), CB("king "), CB("ke"), CB("k"), CB("l c"), CB("lea"), \
+    CB("ll "), CB("los"), CB("la"), CB("le"), CB("li"), CB("lo"), CB("l"), CB("mor"), CB("m "), \
+    CB("me"), CB("mp"), CB("m"), CB("ning "), CB("ng t"), CB("ning"), CB("n, "), CB("nd "), \
+    CB("n "), CB("ne"), CB("n"), CB("one "), CB("ood "), CB("ower"), CB("ode"), CB("oin"), \
+    CB("om "), CB("on "), CB("out"), CB("ove"), CB("of"), CB("ok"), CB("om"), CB("on"), \
+    CB("oo"), CB("op"), CB("or"), CB("os"), CB("ow"), CB("o"), CB("p"), CB("ridge"), CB("rail"), \
+    CB("rai"), CB("re "), CB("rea"), CB("ra"), CB("re"), CB("ro"), CB("r"), CB("se "), \
+    CB("st "), CB("s "), CB("sa"), CB("se"), CB("ss"), CB("st"), CB("s"), CB("t the "), \
+    CB("ter "), CB("t i"), CB("t t"), CB("ter"), CB("t "), CB("ta"), CB("te"), CB("t"), \
+    CB("up "), CB("un"), CB("ur"), CB("ut"), CB("u"), CB("ver"), CB("va"), CB("vi"), CB("v"), \
+    CB("way"), CB("w"), CB("x"), CB("yone"), CB("y "), CB("y"),
@@ -4,187 +4,368 @@
  */
 
 #include "MeshXTCompress.h"
+#include "MeshXTCodebook.h"
+#include "MeshXTCodebookTable.h"
+#include "MeshXTDictTable.h"
+#include "MeshXTEntropy.h"
+#include "MeshXTEntropyModel.h"
+#include "MeshXTSeq.h"
 #include <string.h>
 
-// Common Meshtastic message words — single-byte codes
-const MeshXTCompress::DictEntry MeshXTCompress::dictionary[] = {
-    {"SOS",       0x01},
-    {"HELP",      0x02},
-    {"OK",        0x03},
-    {"YES",       0x04},
-    {"NO",        0x05},
-    {"POSITION",  0x06},
-    {"BATTERY",   0x07},
-    {"LOW",       0x08},
-    {"CHECK",     0x09},
-    {"SAFE",      0x0A},
-    {"MOVING",    0x0B},
-    {"STOPPED",   0x0C},
-    {"CAMP",      0x0D},
-    {"WATER",     0x0E},
-    {"EMERGENCY", 0x0F},
-    {"WEATHER",   0x10},
-    {"CLEAR",     0x11},
-    {"STORM",     0x12},
-    {"TRAIL",     0x13},
-    {"NORTH",     0x14},
-    {"SOUTH",     0x15},
-    {"EAST",      0x16},
-    {"WEST",      0x17},
-    {"COPY",      0x18},
-    {"ROGER",     0x19},
-    {"OVER",      0x1A},
-    {"OUT",       0x1B},
+// The wire format depends on the generated tables, so each format version
+// pins the table versions it was cut for. Regenerating a table with a new
+// --version stops the build here until MESHXT_FORMAT_VERSION is bumped and
+// pinned to the new tables; decoders then reject frames of the other build
+// instead of misreading them.
+#define MESHXT_FORMAT_TABLES(dict, codebook, entropy)                      \
+    (MESHXT_DICT_VERSION == (dict) && MESHXT_CODEBOOK_VERSION == (codebook) && \
+     MESHXT_ENTROPY_MODEL_VERSION == (entropy))
+static_assert(MESHXT_FORMAT_VERSION == 2 && MESHXT_FORMAT_TABLES(1, 1, 1),
+              "generated tables changed: bump MESHXT_FORMAT_VERSION and pin it here");
+static_assert(MESHXT_FORMAT_VERSION < (1 << (8 - MESHXT_CTRL_VERSION_SHIFT)),
+              "format version must fit the control byte");
+#undef MESHXT_FORMAT_TABLES
+
+namespace {
+
+struct DictEntry {
+    const char *word;   // Upper case A-Z
+    uint8_t     len;
+    uint8_t     code;   // Wire code; changes with MESHXT_DICT_VERSION
 };
 
-const uint8_t MeshXTCompress::dictSize = sizeof(dictionary) / sizeof(dictionary[0]);
+#define DICT_WORD(w, code) { w, sizeof(w) - 1, code }
+
+// Trained word list (MeshXTDictTable.h, from tools/gen_codebook.py).
+// Sorted by first letter, longest first within a letter: the matcher
+// takes the first hit in a letter's bucket, which is the longest match.
+constexpr DictEntry dictionary[] = { MESHXT_DICT_ENTRIES };
+
+#undef DICT_WORD
+
+constexpr int dictSize = sizeof(dictionary) / sizeof(dictionary[0]);
+
+// ------------------------------------------------------------
+// Compile-time index and validation (recursion split in halves to keep
+// constexpr depth logarithmic as the dictionary grows)
+// ------------------------------------------------------------
+
+constexpr bool dict_upper(const char *w, int n) {
+    return n == 0 ? true : (w[n - 1] >= 'A' && w[n - 1] <= 'Z' && dict_upper(w, n - 1));
+}
+
+constexpr int dict_code_count(int code, int lo, int hi) {
+    return hi - lo == 0 ? 0
+         : hi - lo == 1 ? (dictionary[lo].code == code ? 1 : 0)
+         : dict_code_count(code, lo, (lo + hi) / 2) + dict_code_count(code, (lo + hi) / 2, hi);
+}
+
+constexpr bool dict_entry_ok(int i) {
+    return dictionary[i].len > 0 &&
+           dict_upper(dictionary[i].word, dictionary[i].len) &&
+           dictionary[i].code != 0x00 && dictionary[i].code != 0xFF &&
+           dict_code_count(dictionary[i].code, 0, dictSize) == 1 &&
+           (i == 0 ||
+            dictionary[i - 1].word[0] < dictionary[i].word[0] ||
+            (dictionary[i - 1].word[0] == dictionary[i].word[0] &&
+             dictionary[i - 1].len >= dictionary[i].len));
+}
+
+constexpr bool dict_valid(int lo, int hi) {
+    return hi - lo == 0 ? true
+         : hi - lo == 1 ? dict_entry_ok(lo)
+         : dict_valid(lo, (lo + hi) / 2) && dict_valid((lo + hi) / 2, hi);
+}
+
+static_assert(dictSize <= 254, "dictionary codes are one byte, 0x00 and 0xFF reserved");
+static_assert(dict_valid(0, dictSize),
+              "dictionary words must be A-Z, sorted by first letter then longest first, "
+              "with unique codes other than 0x00/0xFF");
+
+// First entry whose word starts at or after letter c
+constexpr int dict_lower_bound(int c, int lo, int hi) {
+    return lo >= hi ? lo
+         : dictionary[(lo + hi) / 2].word[0] < c ? dict_lower_bound(c, (lo + hi) / 2 + 1, hi)
+         : dict_lower_bound(c, lo, (lo + hi) / 2);
+}
+
+// Entry with the given code, or -1
+constexpr int dict_find_code(int code, int lo, int hi) {
+    return hi - lo == 0 ? -1
+         : hi - lo == 1 ? (dictionary[lo].code == code ? lo : -1)
+         : dict_find_code(code, lo, (lo + hi) / 2) >= 0 ? dict_find_code(code, lo, (lo + hi) / 2)
+         : dict_find_code(code, (lo + hi) / 2, hi);
+}
+
+struct DictIndex {
+    uint8_t bucket[27];     // Entries starting with 'A' + L are [bucket[L], bucket[L + 1])
+    uint8_t decode[256];    // Code -> entry index + 1, 0 = unassigned
+};
+
+template<int... L, int... C>
+constexpr DictIndex dict_build_index(MeshXTSeq<L...>, MeshXTSeq<C...>) {
+    return DictIndex{ { (uint8_t)dict_lower_bound('A' + L, 0, dictSize)... },
+                      { (uint8_t)(dict_find_code(C, 0, dictSize) + 1)... } };
+}
+
+constexpr DictIndex dictIndex =
+    dict_build_index(MeshXTMakeSeq<27>::type(), MeshXTMakeSeq<256>::type());
+
+// Dictionary tokens are a lead byte giving the case of the word, then its
+// code. Code 0 after a lead byte stands for the lead byte itself.
+constexpr uint8_t DICT_LOWER   = 0xFD;  // water
+constexpr uint8_t DICT_TITLE   = 0xFE;  // Water
+constexpr uint8_t DICT_UPPER   = 0xFF;  // WATER
+constexpr uint8_t DICT_LITERAL = 0x00;
+
+inline bool is_word_char(uint8_t c) {
+    return ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') || (c >= '0' && c <= '9');
+}
+
+// Lead byte for matching p against e, or 0 if the letters differ or the
+// case is mixed (wAter)
+uint8_t dict_case(const uint8_t *p, const DictEntry &e) {
+    bool lower = true, upper = true, title = true;
+    for (uint8_t c = 0; c < e.len; c++) {
+        uint8_t w = (uint8_t)e.word[c];
+        if (p[c] != w && p[c] != (w | 0x20)) return 0;
+        bool isUpper = p[c] == w;
+        if (isUpper) lower = false; else upper = false;
+        if (isUpper != (c == 0)) title = false;
+    }
+    return lower ? DICT_LOWER : upper ? DICT_UPPER : title ? DICT_TITLE : 0;
+}
+
+// ------------------------------------------------------------
+// Decoders, one per payload mode. Each returns the decoded length, or -1
+// on malformed input or if the output would exceed outCap.
+// ------------------------------------------------------------
+
+int raw_decode(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t outCap) {
+    if (inLen > outCap) return -1;
+    memcpy(out, in, inLen);
+    return inLen;
+}
+
+int dict_decode(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t outCap) {
+    uint16_t iIdx = 0;
+    uint16_t oIdx = 0;
+
+    while (iIdx < inLen) {
+        uint8_t lead = in[iIdx];
+        if (lead < DICT_LOWER) {
+            if (oIdx >= outCap) return -1;
+            out[oIdx++] = in[iIdx++];
+            continue;
+        }
+
+        // Token: case lead byte + code, or lead byte + 0 for the literal byte
+        if (iIdx + 1 >= inLen) return -1;
+        uint8_t code = in[iIdx + 1];
+        iIdx += 2;
+        if (code == DICT_LITERAL) {
+            if (oIdx >= outCap) return -1;
+            out[oIdx++] = lead;
+            continue;
+        }
+
+        uint8_t slot = dictIndex.decode[code];
+        if (!slot) return -1;
+        const DictEntry &e = dictionary[slot - 1];
+        if (e.len > outCap - oIdx) return -1;
+        for (uint8_t c = 0; c < e.len; c++) {
+            uint8_t w = (uint8_t)e.word[c];
+            bool lower = lead == DICT_LOWER || (lead == DICT_TITLE && c > 0);
+            out[oIdx++] = lower ? (uint8_t)(w | 0x20) : w;
+        }
+    }
+    return oIdx;
+}
+
+int rle_decode(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t outCap) {
+    uint16_t iIdx = 0;
+    uint16_t oIdx = 0;
+
+    while (iIdx < inLen) {
+        if (in[iIdx] != 0xFE) {
+            if (oIdx >= outCap) return -1;
+            out[oIdx++] = in[iIdx++];
+            continue;
+        }
+
+        // Run: 0xFE count byte
+        if (iIdx + 2 >= inLen) return -1;
+        uint8_t count = in[iIdx + 1];
+        if (count == 0 || count > outCap - oIdx) return -1;
+        memset(out + oIdx, in[iIdx + 2], count);
+        oIdx += count;
+        iIdx += 3;
+    }
+    return oIdx;
+}
+
+int codebook_decode(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t outCap) {
+    return meshxt_decompress_bytes(in, inLen, out, outCap);
+}
+
+int entropy_decode(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t outCap) {
+    return meshxt_entropy_decode(in, inLen, out, outCap);
+}
+
+typedef int (*ModeDecoder)(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t outCap);
+
+// Indexed by MESHXT_MODE_*; NULL = reserved
+constexpr ModeDecoder decoders[MESHXT_MODE_COUNT] = {
+    raw_decode,         // MESHXT_MODE_RAW
+    dict_decode,        // MESHXT_MODE_DICT
+    rle_decode,         // MESHXT_MODE_RLE
+    codebook_decode,    // MESHXT_MODE_CODEBOOK
+    entropy_decode,     // MESHXT_MODE_ENTROPY
+    NULL,               // MESHXT_MODE_POSITION (meshxt_position_decode)
+    NULL, NULL,
+};
+
+} // namespace
 
 MeshXTCompress::MeshXTCompress() {}
 
 int MeshXTCompress::compress(const uint8_t *input, uint16_t inLen,
                               uint8_t *output, uint16_t &outLen) {
     if (inLen == 0) return -1;
+    uint8_t *body = output + MESHXT_COMPRESS_HEADER_SIZE;
+
+    // Size every codec without writing anything. Each dry run is capped at
+    // one byte less than the best so far, so a codec that cannot win stops
+    // as soon as it falls behind. Ties keep the earlier (cheaper) codec.
+    uint8_t mode = MESHXT_MODE_RAW;
+    int best = inLen;
+    int size;
+
+    size = dictCompress(input, inLen, NULL, best - 1);
+    if (size >= 0) { best = size; mode = MESHXT_MODE_DICT; }
 
-    // Add MeshXT header
+    size = rleCompress(input, inLen, NULL, best - 1);
+    if (size >= 0) { best = size; mode = MESHXT_MODE_RLE; }
+
+    size = meshxt_compress_bytes(input, inLen, NULL, best - 1);
+    if (size >= 0) { best = size; mode = MESHXT_MODE_CODEBOOK; }
+
+    size = (int)meshxt_entropy_size(input, inLen);
+    if (size < best) { best = size; mode = MESHXT_MODE_ENTROPY; }
+
+    // Encode once with the winner; it fits in best <= inLen bytes
+    encodeMode(mode, input, inLen, body, best);
+
+    // Add MeshXT header; FEC is added by the caller if wanted
     output[0] = MESHXT_MAGIC_0;
     output[1] = MESHXT_MAGIC_1;
+    output[2] = MESHXT_CTRL(mode);
+    outLen = MESHXT_COMPRESS_HEADER_SIZE + best;
+    return 0;
+}
 
-    // Try dictionary compression first
-    uint16_t compLen;
-    int result = dictCompress(input, inLen, output + MESHXT_HEADER_SIZE, compLen);
-
-    if (result == 0 && compLen < inLen) {
-        outLen = MESHXT_HEADER_SIZE + compLen;
-        return 0;
-    }
+int MeshXTCompress::compressMode(uint8_t mode, const uint8_t *input, uint16_t inLen,
+                                  uint8_t *output, uint16_t outCap, uint16_t &outLen) {
+    if (inLen == 0 || mode >= MESHXT_MODE_COUNT || !decoders[mode]) return -1;
+    if (outCap < MESHXT_COMPRESS_HEADER_SIZE) return -2;
 
-    // Fallback: RLE compression
-    result = rleCompress(input, inLen, output + MESHXT_HEADER_SIZE, compLen);
-    if (result == 0 && compLen < inLen) {
-        outLen = MESHXT_HEADER_SIZE + compLen;
-        return 0;
-    }
+    int size = encodeMode(mode, input, inLen, output + MESHXT_COMPRESS_HEADER_SIZE,
+                          outCap - MESHXT_COMPRESS_HEADER_SIZE);
+    if (size < 0) return -2;
 
-    // No compression benefit — store raw with header
-    memcpy(output + MESHXT_HEADER_SIZE, input, inLen);
-    outLen = MESHXT_HEADER_SIZE + inLen;
+    output[0] = MESHXT_MAGIC_0;
+    output[1] = MESHXT_MAGIC_1;
+    output[2] = MESHXT_CTRL(mode);
+    outLen = (uint16_t)(MESHXT_COMPRESS_HEADER_SIZE + size);
     return 0;
 }
 
+int MeshXTCompress::encodeMode(uint8_t mode, const uint8_t *in, uint16_t inLen,
+                                uint8_t *out, int outCap) {
+    switch (mode) {
+        case MESHXT_MODE_DICT:     return dictCompress(in, inLen, out, outCap);
+        case MESHXT_MODE_RLE:      return rleCompress(in, inLen, out, outCap);
+        case MESHXT_MODE_CODEBOOK: return meshxt_compress_bytes(in, inLen, out, outCap);
+        case MESHXT_MODE_ENTROPY:  return meshxt_entropy_encode(in, inLen, out, outCap);
+        default:
+            if (inLen > outCap) return -1;
+            memcpy(out, in, inLen);
+            return inLen;
+    }
+}
+
 int MeshXTCompress::decompress(const uint8_t *input, uint16_t inLen,
-                                uint8_t *output, uint16_t &outLen) {
-    if (inLen < MESHXT_HEADER_SIZE) return -1;
+                                uint8_t *output, uint16_t outCap, uint16_t &outLen) {
+    if (inLen < MESHXT_COMPRESS_HEADER_SIZE) return -1;
     if (input[0] != MESHXT_MAGIC_0 || input[1] != MESHXT_MAGIC_1) return -2;
 
-    const uint8_t *data = input + MESHXT_HEADER_SIZE;
-    uint16_t dataLen = inLen - MESHXT_HEADER_SIZE;
+    uint8_t ctrl = input[2];
+    if (ctrl & MESHXT_CTRL_FEC_MASK) return -3;  // Parity not stripped
+    if ((ctrl >> MESHXT_CTRL_VERSION_SHIFT) != MESHXT_FORMAT_VERSION) return -4;
 
-    // Try dictionary decompression
-    if (dictDecompress(data, dataLen, output, outLen) == 0) {
-        return 0;
-    }
-
-    // Try RLE decompression
-    if (rleDecompress(data, dataLen, output, outLen) == 0) {
-        return 0;
-    }
+    ModeDecoder decode = decoders[(ctrl & MESHXT_CTRL_MODE_MASK) >> MESHXT_CTRL_MODE_SHIFT];
+    if (!decode) return -4;
 
-    // Raw passthrough
-    memcpy(output, data, dataLen);
-    outLen = dataLen;
+    int n = decode(input + MESHXT_COMPRESS_HEADER_SIZE, inLen - MESHXT_COMPRESS_HEADER_SIZE,
+                   output, outCap);
+    if (n < 0) return -5;
+    outLen = (uint16_t)n;
     return 0;
 }
 
 int MeshXTCompress::dictCompress(const uint8_t *in, uint16_t inLen,
-                                  uint8_t *out, uint16_t &outLen) {
-    // Mark as dictionary-compressed
-    out[0] = 0xD0;  // Dict mode marker
-    uint16_t oIdx = 1;
+                                  uint8_t *out, int outCap) {
+    int oIdx = 0;
     uint16_t iIdx = 0;
 
     while (iIdx < inLen) {
-        bool matched = false;
-
-        // Try to match dictionary entries
-        for (uint8_t d = 0; d < dictSize; d++) {
-            uint8_t wordLen = strlen(dictionary[d].word);
-            if (iIdx + wordLen <= inLen) {
-                // Case-insensitive compare
-                bool match = true;
-                for (uint8_t c = 0; c < wordLen; c++) {
-                    char ic = in[iIdx + c];
-                    if (ic >= 'a' && ic <= 'z') ic -= 32;
-                    if (ic != dictionary[d].word[c]) {
-                        match = false;
-                        break;
-                    }
-                }
-                if (match) {
-                    out[oIdx++] = 0xFF;  // Escape: next byte is dict code
-                    out[oIdx++] = dictionary[d].code;
-                    iIdx += wordLen;
-                    matched = true;
+        uint8_t ch = in[iIdx];
+        uint8_t up = (ch >= 'a' && ch <= 'z') ? (uint8_t)(ch - 32) : ch;
+        const DictEntry *hit = NULL;
+        uint8_t lead = 0;
+
+        // Only whole words are candidates: start of a word here, and only
+        // words sharing the first letter, longest first
+        if (up >= 'A' && up <= 'Z' && (iIdx == 0 || !is_word_char(in[iIdx - 1]))) {
+            uint8_t letter = up - 'A';
+            uint16_t remaining = inLen - iIdx;
+            for (uint8_t d = dictIndex.bucket[letter]; d < dictIndex.bucket[letter + 1]; d++) {
+                const DictEntry &e = dictionary[d];
+                if (e.len > remaining) continue;
+                if (e.len < remaining && is_word_char(in[iIdx + e.len])) continue;
+
+                lead = dict_case(in + iIdx, e);
+                if (lead) {
+                    hit = &e;
                     break;
                 }
             }
         }
 
-        if (!matched) {
-            if (in[iIdx] == 0xFF) {
-                // Escape literal 0xFF
-                out[oIdx++] = 0xFF;
-                out[oIdx++] = 0xFF;
-            } else {
-                out[oIdx++] = in[iIdx];
-            }
-            iIdx++;
-        }
-    }
-
-    outLen = oIdx;
-    return 0;
-}
-
-int MeshXTCompress::dictDecompress(const uint8_t *in, uint16_t inLen,
-                                    uint8_t *out, uint16_t &outLen) {
-    if (inLen < 1 || in[0] != 0xD0) return -1;  // Not dict-compressed
-
-    uint16_t iIdx = 1;
-    uint16_t oIdx = 0;
-
-    while (iIdx < inLen) {
-        if (in[iIdx] == 0xFF && iIdx + 1 < inLen) {
-            uint8_t code = in[iIdx + 1];
-            if (code == 0xFF) {
-                out[oIdx++] = 0xFF;
+        // Token for a word or an escaped literal lead byte, else the byte
+        int need = (hit || ch >= DICT_LOWER) ? 2 : 1;
+        if (oIdx + need > outCap) return -1;
+        if (out) {
+            if (hit) {
+                out[oIdx]     = lead;
+                out[oIdx + 1] = hit->code;
+            } else if (ch >= DICT_LOWER) {
+                out[oIdx]     = ch;
+                out[oIdx + 1] = DICT_LITERAL;
             } else {
-                // Look up dictionary
-                bool found = false;
-                for (uint8_t d = 0; d < dictSize; d++) {
-                    if (dictionary[d].code == code) {
-                        uint8_t wl = strlen(dictionary[d].word);
-                        memcpy(out + oIdx, dictionary[d].word, wl);
-                        oIdx += wl;
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) out[oIdx++] = '?';
+                out[oIdx] = ch;
             }
-            iIdx += 2;
-        } else {
-            out[oIdx++] = in[iIdx++];
         }
+        oIdx += need;
+        iIdx += hit ? hit->len : 1;
     }
 
-    outLen = oIdx;
-    return 0;
+    return oIdx;
 }
 
 int MeshXTCompress::rleCompress(const uint8_t *in, uint16_t inLen,
-                                 uint8_t *out, uint16_t &outLen) {
-    out[0] = 0xE0;  // RLE mode marker
-    uint16_t oIdx = 1;
+                                 uint8_t *out, int outCap) {
+    int oIdx = 0;
 
     for (uint16_t i = 0; i < inLen; ) {
         uint8_t ch = in[i];
@@ -193,42 +374,24 @@ int MeshXTCompress::rleCompress(const uint8_t *in, uint16_t inLen,
             count++;
         }
 
-        if (count >= 3) {
-            out[oIdx++] = 0xFE;  // RLE marker
-            out[oIdx++] = count;
-            out[oIdx++] = ch;
+        // A literal 0xFE would read as a run marker, so it always goes as a run
+        if (count >= 3 || ch == 0xFE) {
+            if (oIdx + 3 > outCap) return -1;
+            if (out) {
+                out[oIdx]     = 0xFE;  // RLE marker
+                out[oIdx + 1] = count;
+                out[oIdx + 2] = ch;
+            }
+            oIdx += 3;
         } else {
-            for (uint8_t j = 0; j < count; j++) {
-                out[oIdx++] = ch;
+            if (oIdx + count > outCap) return -1;
+            for (uint8_t j = 0; out && j < count; j++) {
+                out[oIdx + j] = ch;
             }
+            oIdx += count;
         }
         i += count;
     }
 
-    outLen = oIdx;
-    return 0;
-}
-
-int MeshXTCompress::rleDecompress(const uint8_t *in, uint16_t inLen,
-                                   uint8_t *out, uint16_t &outLen) {
-    if (inLen < 1 || in[0] != 0xE0) return -1;
-
-    uint16_t iIdx = 1;
-    uint16_t oIdx = 0;
-
-    while (iIdx < inLen) {
-        if (in[iIdx] == 0xFE && iIdx + 2 < inLen) {
-            uint8_t count = in[iIdx + 1];
-            uint8_t ch    = in[iIdx + 2];
-            for (uint8_t j = 0; j < count; j++) {
-                out[oIdx++] = ch;
-            }
-            iIdx += 3;
-        } else {
-            out[oIdx++] = in[iIdx++];
-        }
-    }
-
-    outLen = oIdx;
-    return 0;
+    return oIdx;
 }
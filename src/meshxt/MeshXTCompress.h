@@ -10,7 +10,31 @@
 
 #define MESHXT_MAGIC_0  0x4D  // 'M'
 #define MESHXT_MAGIC_1  0x58  // 'X'
-#define MESHXT_HEADER_SIZE 2
+#define MESHXT_COMPRESS_HEADER_SIZE 3   // 'M' 'X' control
+
+// Control byte (header byte 2)
+//   Bits 1-0: FEC level code (MESHXT_FEC_*_CODE) of the RS parity that
+//             covers the bytes after the header; 0 = no parity
+//   Bits 4-2: Payload mode (MESHXT_MODE_*), the codec of the bytes after
+//             the header
+//   Bits 7-5: Format version (MESHXT_FORMAT_VERSION)
+#define MESHXT_CTRL_FEC_MASK       0x03
+#define MESHXT_CTRL_MODE_MASK      0x1C
+#define MESHXT_CTRL_MODE_SHIFT     2
+#define MESHXT_CTRL_VERSION_SHIFT  5
+#define MESHXT_FORMAT_VERSION      2   // Bump with the generated tables; see MeshXTCompress.cpp
+
+#define MESHXT_MODE_RAW       0   // Stored as-is
+#define MESHXT_MODE_DICT      1   // Word dictionary, 0xFD-0xFF tokens
+#define MESHXT_MODE_RLE       2   // Runs as 0xFE count byte
+#define MESHXT_MODE_CODEBOOK  3   // MeshXTCodebook.h
+#define MESHXT_MODE_ENTROPY   4   // MeshXTEntropy.h
+#define MESHXT_MODE_POSITION  5   // MeshXTPosition.h; per-node state, not decoded by decompress()
+#define MESHXT_MODE_COUNT     8   // Size of the mode field; 6-7 reserved
+
+// Control byte for an unprotected frame of the given mode
+#define MESHXT_CTRL(mode)  ((uint8_t)((MESHXT_FORMAT_VERSION << MESHXT_CTRL_VERSION_SHIFT) | \
+                                      ((mode) << MESHXT_CTRL_MODE_SHIFT)))
 
 class MeshXTCompress {
 public:
@@ -18,9 +42,11 @@ public:
 
     /**
      * Compress a message payload.
+     * Sizes each codec (dictionary, RLE, codebook, entropy) without
+     * encoding, then encodes once with the smallest; raw if none is smaller.
      * @param input   Raw message bytes
      * @param inLen   Input length
-     * @param output  Compressed output buffer (must be >= inLen + MESHXT_HEADER_SIZE)
+     * @param output  Compressed output buffer (must be >= inLen + MESHXT_COMPRESS_HEADER_SIZE)
      * @param outLen  Output length (set on success)
      * @return 0 on success, negative on error
      */
@@ -28,28 +54,37 @@ public:
 
     /**
      * Decompress a MeshXT-compressed payload.
+     * FEC parity must already be stripped (control FEC bits zero). The
+     * control byte's mode selects the one decoder that runs.
      * @param input   Compressed bytes (with MeshXT header)
      * @param inLen   Input length
      * @param output  Decompressed output buffer
+     * @param outCap  Capacity of output in bytes
      * @param outLen  Output length (set on success)
-     * @return 0 on success, negative on error
+     * @return 0 on success, -1 short input, -2 bad magic, -3 FEC present,
+     *         -4 unknown version or mode (including MESHXT_MODE_POSITION,
+     *         which needs per-node state), -5 corrupt or larger than outCap
+     */
+    int decompress(const uint8_t *input, uint16_t inLen, uint8_t *output, uint16_t outCap,
+                   uint16_t &outLen);
+
+    /**
+     * Compress with the given payload mode even if another is smaller.
+     * For host tools that check each codec (tools/compress_roundtrip.cpp).
+     * @param mode    MESHXT_MODE_* with a decoder (not POSITION)
+     * @param outCap  Capacity of output in bytes; a forced codec may expand
+     * @return 0 on success, -1 empty input or unsupported mode,
+     *         -2 output larger than outCap
      */
-    int decompress(const uint8_t *input, uint16_t inLen, uint8_t *output, uint16_t &outLen);
+    int compressMode(uint8_t mode, const uint8_t *input, uint16_t inLen, uint8_t *output,
+                     uint16_t outCap, uint16_t &outLen);
 
 private:
-    // Simple dictionary for common Meshtastic words
-    struct DictEntry {
-        const char *word;
-        uint8_t     code;
-    };
-
-    static const DictEntry dictionary[];
-    static const uint8_t   dictSize;
-
-    int  dictCompress(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t &outLen);
-    int  dictDecompress(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t &outLen);
-    int  rleCompress(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t &outLen);
-    int  rleDecompress(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t &outLen);
+    // Encoders return the encoded length, or -1 once it would exceed
+    // outCap. With out == NULL they only measure.
+    int  dictCompress(const uint8_t *in, uint16_t inLen, uint8_t *out, int outCap);
+    int  rleCompress(const uint8_t *in, uint16_t inLen, uint8_t *out, int outCap);
+    int  encodeMode(uint8_t mode, const uint8_t *in, uint16_t inLen, uint8_t *out, int outCap);
 };
 
 #endif // MESHXT_COMPRESS_H
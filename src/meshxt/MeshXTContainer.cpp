@@ -0,0 +1,218 @@
+#include "MeshXTContainer.h"
+#include <string.h>
+
+static inline uint32_t get_be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void put_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static size_t varint_size(uint32_t v) {
+    size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+void meshxt_container_begin(MeshXTContainer *c, uint8_t *buf, size_t cap) {
+    memset(c, 0, sizeof(*c));
+    c->buf = buf;
+    c->cap = cap;
+}
+
+// Format 1: a v1 relay frame as a record of changed header fields
+static int add_fields(MeshXTContainer *c, const uint8_t *frame, size_t frameLen) {
+    if (frameLen < MESHXT_RELAY_FRAME_HEADER) return -1;
+
+    uint8_t  version = frame[0];
+    uint32_t src     = get_be32(frame + 1);
+    uint32_t dest    = get_be32(frame + 5);
+    uint8_t  channel = frame[9];
+    uint32_t time    = get_be32(frame + 10);
+    const uint8_t *payload = frame + MESHXT_RELAY_FRAME_HEADER;
+    size_t payloadLen = frameLen - MESHXT_RELAY_FRAME_HEADER;
+
+    if (version != MESHXT_RELAY_V1 || payloadLen > 0xFF) return -1;
+
+    bool first = c->count == 0;
+
+    uint32_t base = first ? time : c->baseTime;
+    uint32_t dt   = zigzag((int32_t)(time - base));
+
+    uint8_t flags = (src != c->src ? MESHXT_CONTAINER_NEW_SRC : 0) |
+                    (dest != c->dest ? MESHXT_CONTAINER_NEW_DEST : 0) |
+                    (channel != c->channel ? MESHXT_CONTAINER_NEW_CHAN : 0) |
+                    (dt ? MESHXT_CONTAINER_TIME : 0);
+
+    size_t need = (first ? MESHXT_CONTAINER_HEADER : 0) + 2 +
+                  ((flags & MESHXT_CONTAINER_NEW_SRC) ? 4 : 0) +
+                  ((flags & MESHXT_CONTAINER_NEW_DEST) ? 4 : 0) +
+                  ((flags & MESHXT_CONTAINER_NEW_CHAN) ? 1 : 0) +
+                  ((flags & MESHXT_CONTAINER_TIME) ? varint_size(dt) : 0) +
+                  payloadLen;
+    if (need > c->cap - c->len) return -1;
+
+    uint8_t *o = c->buf + c->len;
+    if (first) {
+        *o++ = MESHXT_CONTAINER_TAG | MESHXT_CONTAINER_FIELDS;
+        put_be32(o, time);
+        o += 4;
+        c->baseTime = time;
+    }
+
+    *o++ = flags;
+    *o++ = (uint8_t)payloadLen;
+    if (flags & MESHXT_CONTAINER_NEW_SRC) {
+        put_be32(o, src);
+        o += 4;
+    }
+    if (flags & MESHXT_CONTAINER_NEW_DEST) {
+        put_be32(o, dest);
+        o += 4;
+    }
+    if (flags & MESHXT_CONTAINER_NEW_CHAN) *o++ = channel;
+    if (flags & MESHXT_CONTAINER_TIME) {
+        while (dt >= 0x80) {
+            *o++ = (uint8_t)(dt | 0x80);
+            dt >>= 7;
+        }
+        *o++ = (uint8_t)dt;
+    }
+    memcpy(o, payload, payloadLen);
+
+    c->len    += need;
+    c->src     = src;
+    c->dest    = dest;
+    c->channel = channel;
+    return 0;
+}
+
+// Format 2: any relay frame, length-prefixed
+static int add_frame(MeshXTContainer *c, const uint8_t *frame, size_t frameLen) {
+    if (frameLen == 0 || frameLen > 0xFF) return -1;
+    if (frame[0] & MESHXT_CONTAINER_TAG_MASK) return -1;
+
+    bool first = c->count == 0;
+    size_t need = (first ? 1 : 0) + 1 + frameLen;
+    if (need > c->cap - c->len) return -1;
+
+    uint8_t *o = c->buf + c->len;
+    if (first) *o++ = MESHXT_CONTAINER_TAG | MESHXT_CONTAINER_FRAMES;
+    *o++ = (uint8_t)frameLen;
+    memcpy(o, frame, frameLen);
+
+    c->len += need;
+    return 0;
+}
+
+int meshxt_container_add(MeshXTContainer *c, const uint8_t *frame, size_t frameLen) {
+    if (frameLen == 0 || c->count == 0xFF) return -1;
+    if (c->count == 0) {
+        c->format = frame[0] == MESHXT_RELAY_V1 ? MESHXT_CONTAINER_FIELDS : MESHXT_CONTAINER_FRAMES;
+    }
+
+    int rc = c->format == MESHXT_CONTAINER_FIELDS ? add_fields(c, frame, frameLen)
+                                                   : add_frame(c, frame, frameLen);
+    if (rc == 0) c->count++;
+    return rc;
+}
+
+bool meshxt_container_is(const uint8_t *data, size_t len) {
+    return len >= 1 && (data[0] & MESHXT_CONTAINER_TAG_MASK) == MESHXT_CONTAINER_TAG;
+}
+
+int meshxt_container_open(MeshXTContainerReader *r, const uint8_t *data, size_t len) {
+    if (!meshxt_container_is(data, len)) return -1;
+
+    memset(r, 0, sizeof(*r));
+    r->buf    = data;
+    r->len    = len;
+    r->format = data[0] & ~MESHXT_CONTAINER_TAG_MASK;
+
+    if (r->format == MESHXT_CONTAINER_FIELDS) {
+        if (len < MESHXT_CONTAINER_HEADER) return -1;
+        r->pos      = MESHXT_CONTAINER_HEADER;
+        r->baseTime = get_be32(data + 1);
+    } else if (r->format == MESHXT_CONTAINER_FRAMES) {
+        r->pos = 1;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+int meshxt_container_next(MeshXTContainerReader *r, uint8_t *frame, size_t frameCap) {
+    if (r->pos >= r->len) return 0;
+
+    const uint8_t *in = r->buf;
+    size_t i = r->pos;
+
+    if (r->format == MESHXT_CONTAINER_FRAMES) {
+        size_t frameLen = in[i++];
+        if (frameLen == 0 || r->len - i < frameLen || frameCap < frameLen) return -1;
+        memcpy(frame, in + i, frameLen);
+        r->pos = i + frameLen;
+        return (int)frameLen;
+    }
+    if (r->len - i < 2) return -1;
+    uint8_t flags      = in[i++];
+    size_t  payloadLen = in[i++];
+    uint32_t src = r->src, dest = r->dest, time = r->baseTime;
+    uint8_t  channel = r->channel;
+
+    if (flags & 0x0F) return -1;
+    if (flags & MESHXT_CONTAINER_NEW_SRC) {
+        if (r->len - i < 4) return -1;
+        src = get_be32(in + i);
+        i += 4;
+    }
+    if (flags & MESHXT_CONTAINER_NEW_DEST) {
+        if (r->len - i < 4) return -1;
+        dest = get_be32(in + i);
+        i += 4;
+    }
+    if (flags & MESHXT_CONTAINER_NEW_CHAN) {
+        if (r->len - i < 1) return -1;
+        channel = in[i++];
+    }
+    if (flags & MESHXT_CONTAINER_TIME) {
+        uint32_t dt = 0;
+        for (int shift = 0;; shift += 7) {
+            if (i >= r->len || shift > 28) return -1;
+            uint8_t b = in[i++];
+            dt |= (uint32_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+        }
+        time = r->baseTime + (uint32_t)unzigzag(dt);
+    }
+    if (r->len - i < payloadLen) return -1;
+    if (frameCap < MESHXT_RELAY_FRAME_HEADER + payloadLen) return -1;
+
+    frame[0] = MESHXT_RELAY_V1;
+    put_be32(frame + 1, src);
+    put_be32(frame + 5, dest);
+    frame[9] = channel;
+    put_be32(frame + 10, time);
+    memcpy(frame + MESHXT_RELAY_FRAME_HEADER, in + i, payloadLen);
+
+    r->pos     = i + payloadLen;
+    r->src     = src;
+    r->dest    = dest;
+    r->channel = channel;
+    return (int)(MESHXT_RELAY_FRAME_HEADER + payloadLen);
+}
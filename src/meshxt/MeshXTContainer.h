@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * MeshXT container frames: several relay frames in one uplink
+ *
+ * A short compressed message is often smaller than the 14-byte relay
+ * header in front of it, and every uplink also pays the LoRaWAN MAC
+ * overhead and preamble. A container carries several relay frames in one
+ * uplink. The first frame added picks the format.
+ *
+ * Container:
+ *   Byte 0:    0xC0 | format (relay frames start with a byte below 0x40,
+ *              so byte 0 tells the two apart)
+ *
+ * Format 1, v1 relay frames (14-byte header): header fields are carried
+ * once and each message is a record repeating only what changed.
+ *   Byte 1-4:  Base timestamp (big-endian), that of the first record
+ *   Byte 5+:   Records
+ *
+ * Record:
+ *   Byte 0:    [SDCT xxxx] New source | New destination | New channel |
+ *              Timestamp differs from base | reserved
+ *   Byte 1:    Payload length
+ *   Then, in order and only if flagged: source (4, big-endian),
+ *   destination (4, big-endian), channel (1), zigzag varint timestamp
+ *   minus base. Unflagged fields repeat the previous record (source,
+ *   destination and channel start at 0). Then the payload.
+ *
+ * v1 relay frame (unpacked): version(1) src(4) dest(4) channel(1)
+ * timestamp(4) payload, multi-byte fields big-endian.
+ *
+ * Format 2, any other relay frame (the v2 header is already compact):
+ *   Byte 1+:   Records of [length][relay frame]
+ */
+
+#define MESHXT_CONTAINER_TAG        0xC0
+#define MESHXT_CONTAINER_TAG_MASK   0xC0
+#define MESHXT_CONTAINER_FIELDS     1    // Format 1
+#define MESHXT_CONTAINER_FRAMES     2    // Format 2
+#define MESHXT_CONTAINER_HEADER     5    // Format 1; format 2 has only byte 0
+#define MESHXT_RELAY_FRAME_HEADER   14   // Same as RELAY_HEADER_SIZE (PacketTranslator.h)
+#define MESHXT_RELAY_V1             1    // Relay version packed as format 1
+
+// Record flags
+#define MESHXT_CONTAINER_NEW_SRC    0x80
+#define MESHXT_CONTAINER_NEW_DEST   0x40
+#define MESHXT_CONTAINER_NEW_CHAN   0x20
+#define MESHXT_CONTAINER_TIME       0x10
+
+/**
+ * Container being built in a caller buffer.
+ */
+typedef struct {
+    uint8_t *buf;
+    size_t   cap;
+    size_t   len;           // 0 until the first record
+    uint8_t  count;         // Records added
+    uint8_t  format;
+    uint32_t baseTime;
+    uint32_t src;           // Fields of the previous record
+    uint32_t dest;
+    uint8_t  channel;
+} MeshXTContainer;
+
+/**
+ * Container being split.
+ */
+typedef struct {
+    const uint8_t *buf;
+    size_t   len;
+    size_t   pos;
+    uint8_t  format;
+    uint32_t baseTime;
+    uint32_t src;
+    uint32_t dest;
+    uint8_t  channel;
+} MeshXTContainerReader;
+
+/**
+ * Start an empty container in buf.
+ */
+void meshxt_container_begin(MeshXTContainer *c, uint8_t *buf, size_t cap);
+
+/**
+ * Append a relay frame as the next record. Leaves the container
+ * unchanged if the record does not fit.
+ *
+ * @return  0 if added, -1 if it does not fit, the frame is malformed or
+ *          it does not suit the container's format
+ */
+int meshxt_container_add(MeshXTContainer *c, const uint8_t *frame, size_t frameLen);
+
+/**
+ * Whether an uplink payload is a container rather than a relay frame.
+ */
+bool meshxt_container_is(const uint8_t *data, size_t len);
+
+/**
+ * Start splitting a container.
+ *
+ * @return  0 on success, -1 if data is not a container
+ */
+int meshxt_container_open(MeshXTContainerReader *r, const uint8_t *data, size_t len);
+
+/**
+ * Rebuild the next record as a relay frame.
+ *
+ * @param frame     Output relay frame
+ * @param frameCap  Capacity of frame
+ * @return          Frame length, 0 after the last record, or -1 if the
+ *                  container is corrupt or frame is too small
+ */
+int meshxt_container_next(MeshXTContainerReader *r, uint8_t *frame, size_t frameCap);
@@ -0,0 +1,31 @@
+#pragma once
+
+// Generated by tools/gen_codebook.py from tools/corpus/mesh_chat.txt — do not edit.
+// Expected size on the corpus: 81.6% of the input.
+
+#define MESHXT_DICT_VERSION 1
+
+// Upper-case words with their wire codes; DICT_WORD() is defined by MeshXTCompress.cpp
+#define MESHXT_DICT_ENTRIES \
+    DICT_WORD("ANYONE", 0x17), DICT_WORD("AGAIN", 0x06), DICT_WORD("ALL", 0x16), \
+    DICT_WORD("BATTERY", 0x04), DICT_WORD("BRIDGE", 0x18), DICT_WORD("BROKEN", 0x39), \
+    DICT_WORD("BRING", 0x32), DICT_WORD("BACK", 0x10), DICT_WORD("BASE", 0x38), \
+    DICT_WORD("CHECKING", 0x19), DICT_WORD("CHANNEL", 0x0D), DICT_WORD("CLOSED", 0x3A), \
+    DICT_WORD("COMING", 0x3B), DICT_WORD("CHECK", 0x33), DICT_WORD("CLEAR", 0x0E), \
+    DICT_WORD("CAMP", 0x07), DICT_WORD("COPY", 0x21), DICT_WORD("EVERYONE", 0x08), \
+    DICT_WORD("FINE", 0x3C), DICT_WORD("FROM", 0x23), DICT_WORD("FOR", 0x22), \
+    DICT_WORD("GOING", 0x1A), DICT_WORD("GOOD", 0x11), DICT_WORD("HEADING", 0x24), \
+    DICT_WORD("HERE", 0x3D), DICT_WORD("LEAVING", 0x25), DICT_WORD("LOST", 0x3E), \
+    DICT_WORD("MEDICAL", 0x26), DICT_WORD("MESSAGE", 0x27), DICT_WORD("MOVING", 0x1B), \
+    DICT_WORD("NIGHT", 0x34), DICT_WORD("NORTH", 0x35), DICT_WORD("NEED", 0x12), \
+    DICT_WORD("NODE", 0x28), DICT_WORD("OFFLINE", 0x29), DICT_WORD("ONLINE", 0x3F), \
+    DICT_WORD("POSITION", 0x02), DICT_WORD("PICKING", 0x2A), DICT_WORD("PLEASE", 0x1C), \
+    DICT_WORD("POWER", 0x1D), DICT_WORD("RECEIVED", 0x1E), DICT_WORD("REACHED", 0x2B), \
+    DICT_WORD("RUNNING", 0x2C), DICT_WORD("RIDGE", 0x1F), DICT_WORD("RIVER", 0x36), \
+    DICT_WORD("SATELLITE", 0x13), DICT_WORD("SWITCHING", 0x14), DICT_WORD("SHELTER", 0x2D), \
+    DICT_WORD("STOPPED", 0x2E), DICT_WORD("SUMMIT", 0x20), DICT_WORD("SAFE", 0x40), \
+    DICT_WORD("TRAILHEAD", 0x15), DICT_WORD("TOMORROW", 0x09), DICT_WORD("TURNING", 0x0F), \
+    DICT_WORD("THANKS", 0x03), DICT_WORD("THERE", 0x37), DICT_WORD("TRAIL", 0x0A), \
+    DICT_WORD("TEAM", 0x2F), DICT_WORD("THE", 0x01), DICT_WORD("VISIBILITY", 0x0C), \
+    DICT_WORD("WAYPOINT", 0x0B), DICT_WORD("WEATHER", 0x30), DICT_WORD("WATER", 0x05), \
+    DICT_WORD("YOU", 0x31),
@@ -0,0 +1,206 @@
+#include "MeshXTEntropy.h"
+#include "MeshXTEntropyModel.h"
+#include "MeshXTSeq.h"
+
+namespace {
+
+constexpr int kSymbols = MESHXT_ENTROPY_SYMBOLS;
+constexpr int kEscape  = MESHXT_ENTROPY_SYMBOLS - 1;
+constexpr int kMaxBits = MESHXT_ENTROPY_MAX_BITS;
+
+// ------------------------------------------------------------
+// Canonical code construction from the generated lengths
+// ------------------------------------------------------------
+
+constexpr int ent_len(int ctx, int s) {
+    return meshxt_entropy_lengths[ctx][s];
+}
+
+// Symbols in [lo, hi) with code length n
+constexpr int ent_count(int ctx, int n, int lo, int hi) {
+    return hi - lo == 0 ? 0
+         : hi - lo == 1 ? (ent_len(ctx, lo) == n ? 1 : 0)
+         : ent_count(ctx, n, lo, (lo + hi) / 2) + ent_count(ctx, n, (lo + hi) / 2, hi);
+}
+
+// Symbols in [lo, hi) with code length below n
+constexpr int ent_shorter(int ctx, int n, int lo, int hi) {
+    return hi - lo == 0 ? 0
+         : hi - lo == 1 ? (ent_len(ctx, lo) < n ? 1 : 0)
+         : ent_shorter(ctx, n, lo, (lo + hi) / 2) + ent_shorter(ctx, n, (lo + hi) / 2, hi);
+}
+
+constexpr int ent_first_code(int ctx, int n) {
+    return n <= 1 ? 0 : (ent_first_code(ctx, n - 1) + ent_count(ctx, n - 1, 0, kSymbols)) << 1;
+}
+
+constexpr int ent_code(int ctx, int s) {
+    return ent_first_code(ctx, ent_len(ctx, s)) + ent_count(ctx, ent_len(ctx, s), 0, s);
+}
+
+constexpr int ent_rank(int ctx, int s) {
+    return ent_shorter(ctx, ent_len(ctx, s), 0, kSymbols) + ent_count(ctx, ent_len(ctx, s), 0, s);
+}
+
+// ------------------------------------------------------------
+// Model validation
+// ------------------------------------------------------------
+
+constexpr long ent_kraft(int ctx, int lo, int hi) {
+    return hi - lo == 0 ? 0
+         : hi - lo == 1 ? (1L << (kMaxBits - ent_len(ctx, lo)))
+         : ent_kraft(ctx, lo, (lo + hi) / 2) + ent_kraft(ctx, (lo + hi) / 2, hi);
+}
+
+constexpr bool ent_symbol_ok(int ctx, int p) {
+    return ent_len(ctx, p) >= 1 && ent_len(ctx, p) <= kMaxBits &&
+           meshxt_entropy_sorted[ctx][p] < kSymbols &&
+           ent_rank(ctx, meshxt_entropy_sorted[ctx][p]) == p;
+}
+
+constexpr bool ent_symbols_ok(int ctx, int lo, int hi) {
+    return hi - lo == 1 ? ent_symbol_ok(ctx, lo)
+         : ent_symbols_ok(ctx, lo, (lo + hi) / 2) && ent_symbols_ok(ctx, (lo + hi) / 2, hi);
+}
+
+constexpr bool ent_context_ok(int ctx) {
+    return ent_symbols_ok(ctx, 0, kSymbols) &&
+           ent_kraft(ctx, 0, kSymbols) == (1L << kMaxBits) &&
+           ent_shorter(ctx, 8, 0, kSymbols) < kSymbols;
+}
+
+constexpr bool ent_model_ok(int ctx) {
+    return ctx == MESHXT_ENTROPY_CONTEXTS ? true : ent_context_ok(ctx) && ent_model_ok(ctx + 1);
+}
+
+static_assert(kMaxBits <= 16, "codes are stored in 16 bits");
+static_assert(ent_model_ok(0),
+              "entropy model must be complete prefix codes of 1..MAX_BITS bits with a code of at "
+              "least 8 bits per context, and sorted[] must be canonical order; rerun "
+              "tools/gen_entropy_model.py");
+
+// ------------------------------------------------------------
+// Derived tables (flash)
+// ------------------------------------------------------------
+
+struct EntropyTables {
+    uint16_t code[MESHXT_ENTROPY_CONTEXTS * kSymbols];           // Canonical code per symbol
+    uint8_t  count[MESHXT_ENTROPY_CONTEXTS * (kMaxBits + 1)];    // Codes per length
+};
+
+template<int... K, int... C>
+constexpr EntropyTables ent_build(MeshXTSeq<K...>, MeshXTSeq<C...>) {
+    return EntropyTables{
+        { (uint16_t)ent_code(K / kSymbols, K % kSymbols)... },
+        { (uint8_t)ent_count(C / (kMaxBits + 1), C % (kMaxBits + 1), 0, kSymbols)... } };
+}
+
+constexpr EntropyTables tables =
+    ent_build(MeshXTMakeSeq<MESHXT_ENTROPY_CONTEXTS * kSymbols>::type(),
+              MeshXTMakeSeq<MESHXT_ENTROPY_CONTEXTS * (kMaxBits + 1)>::type());
+
+// Must match context_of() in tools/gen_entropy_model.py
+inline int meshxt_entropy_context(uint8_t prev) {
+    if (prev == ' ') return 0;
+    if (prev == 'a' || prev == 'e' || prev == 'i' || prev == 'o' || prev == 'u') return 1;
+    if (prev >= 'a' && prev <= 'z') return 2;
+    if (prev >= 'A' && prev <= 'Z') return 3;
+    if (prev >= '0' && prev <= '9') return 4;
+    return 5;
+}
+
+inline int symbol_of(uint8_t b) {
+    return (b >= 0x20 && b <= 0x7E) ? b - 0x20 : kEscape;
+}
+
+} // namespace
+
+size_t meshxt_entropy_size(const uint8_t *in, size_t inLen) {
+    size_t bits = 0;
+    uint8_t prev = ' ';
+    for (size_t i = 0; i < inLen; i++) {
+        int s = symbol_of(in[i]);
+        bits += meshxt_entropy_lengths[meshxt_entropy_context(prev)][s] + (s == kEscape ? 8 : 0);
+        prev = in[i];
+    }
+    return (bits + 7) / 8;
+}
+
+int meshxt_entropy_encode(const uint8_t *in, size_t inLen, uint8_t *out, size_t outCap) {
+    uint32_t acc = 0;   // Pending bits, right-aligned
+    int      nbits = 0;
+    size_t   o = 0;
+    uint8_t  prev = ' ';
+
+    for (size_t i = 0; i < inLen; i++) {
+        int ctx = meshxt_entropy_context(prev);
+        int s = symbol_of(in[i]);
+
+        acc = (acc << meshxt_entropy_lengths[ctx][s]) | tables.code[ctx * kSymbols + s];
+        nbits += meshxt_entropy_lengths[ctx][s];
+        if (s == kEscape) {
+            acc = (acc << 8) | in[i];
+            nbits += 8;
+        }
+
+        while (nbits >= 8) {
+            if (o >= outCap) return -1;
+            nbits -= 8;
+            out[o++] = (uint8_t)(acc >> nbits);
+        }
+        prev = in[i];
+    }
+
+    if (nbits > 0) {
+        if (o >= outCap) return -1;
+        out[o++] = (uint8_t)((acc << (8 - nbits)) | (0xFF >> nbits));
+    }
+    return (int)o;
+}
+
+int meshxt_entropy_decode(const uint8_t *in, size_t inLen, uint8_t *out, size_t outCap) {
+    size_t totalBits = inLen * 8;
+    size_t pos = 0;     // Bit position
+    size_t o = 0;
+    uint8_t prev = ' ';
+
+    while (pos < totalBits) {
+        // Fewer than 8 bits left and all ones: tail padding
+        size_t left = totalBits - pos;
+        if (left < 8 && (uint8_t)(in[inLen - 1] | (0xFF << left)) == 0xFF) break;
+
+        // Canonical decode: walk lengths, comparing against the first code of each
+        int ctx = meshxt_entropy_context(prev);
+        const uint8_t *count = &tables.count[ctx * (kMaxBits + 1)];
+        int code = 0, first = 0, index = 0, sym = -1;
+        for (int len = 1; len <= kMaxBits; len++) {
+            if (pos >= totalBits) return -1;
+            code |= (in[pos >> 3] >> (7 - (pos & 7))) & 1;
+            pos++;
+            if (code - first < count[len]) {
+                sym = meshxt_entropy_sorted[ctx][index + code - first];
+                break;
+            }
+            index += count[len];
+            first = (first + count[len]) << 1;
+            code <<= 1;
+        }
+        if (sym < 0) return -1;
+
+        uint8_t b;
+        if (sym == kEscape) {
+            if (totalBits - pos < 8) return -1;
+            b = 0;
+            for (int k = 0; k < 8; k++, pos++) {
+                b = (uint8_t)((b << 1) | ((in[pos >> 3] >> (7 - (pos & 7))) & 1));
+            }
+        } else {
+            b = (uint8_t)(sym + 0x20);
+        }
+
+        if (o >= outCap) return -1;
+        out[o++] = b;
+        prev = b;
+    }
+    return (int)o;
+}
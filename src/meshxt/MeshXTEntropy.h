@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * MeshXT static entropy coder
+ *
+ * Canonical Huffman with a fixed model trained on mesh chat
+ * (tools/gen_entropy_model.py -> MeshXTEntropyModel.h). Each byte is coded
+ * in the context of the class of the byte before it (space, vowel,
+ * consonant, upper case, digit, other), so common letter sequences cost
+ * 3-5 bits instead of 8. Printable ASCII has a code in every context;
+ * any other byte is an escape code followed by its 8 raw bits.
+ *
+ * Bits are packed MSB first. The last byte is padded with 1-bits; every
+ * model has codes of at least 8 bits, so the padding never decodes as a
+ * symbol and no length field is needed.
+ *
+ * Both directions use only compile-time tables (about 2.4 KB of flash),
+ * no heap and a few bytes of stack.
+ */
+
+/**
+ * Encode bytes.
+ *
+ * @param in      Input bytes
+ * @param inLen   Input length
+ * @param out     Output buffer
+ * @param outCap  Capacity of out in bytes
+ * @return        Encoded length, or -1 if it does not fit outCap
+ */
+int meshxt_entropy_encode(const uint8_t *in, size_t inLen, uint8_t *out, size_t outCap);
+
+/**
+ * Encoded size in bytes without producing output.
+ */
+size_t meshxt_entropy_size(const uint8_t *in, size_t inLen);
+
+/**
+ * Decode bytes.
+ *
+ * @param in      Encoded bytes
+ * @param inLen   Encoded length
+ * @param out     Output buffer
+ * @param outCap  Capacity of out in bytes
+ * @return        Decoded length, or -1 on corrupt input or if out is too small
+ */
+int meshxt_entropy_decode(const uint8_t *in, size_t inLen, uint8_t *out, size_t outCap);
@@ -0,0 +1,91 @@
+#pragma once
+
+// Generated by tools/gen_entropy_model.py from tools/corpus/mesh_chat.txt — do not edit.
+// Expected size on the training corpus: 53.7% of the input.
+
+#include <stdint.h>
+
+#define MESHXT_ENTROPY_MODEL_VERSION 1
+#define MESHXT_ENTROPY_CONTEXTS      6
+#define MESHXT_ENTROPY_SYMBOLS       96
+#define MESHXT_ENTROPY_MAX_BITS      12
+
+// Code length in bits of each symbol (byte - 0x20; 95 = escape) per context
+constexpr uint8_t meshxt_entropy_lengths[MESHXT_ENTROPY_CONTEXTS][MESHXT_ENTROPY_SYMBOLS] = {
+    {   // after space/start
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,  7, 12, 12, 12,  6,  6,  7,  7,  7,  8,  7,
+         8, 12,  9, 12, 12, 12, 12, 12, 12,  6,  6,  6,  8,  7,  6,  6,  7,  7, 12, 12,  7,  7,  7,  7,
+         7, 12,  6,  5,  6,  9,  9,  6, 12,  9, 12, 12, 12, 12, 12, 12, 12,  4,  5,  4,  6,  7,  5,  6,
+         5,  5,  9,  7,  6,  5,  5,  5,  6,  9,  5,  5,  3,  6,  8,  5, 12,  6,  9, 12, 12, 12, 12, 12,
+    },
+    {   // after vowel
+         3, 10, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,  7, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12,  9, 12, 12, 12, 12,  9, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,  5,  8,  5,  4,  6,  6,  6,
+         9,  5, 12,  7,  4,  5,  3,  6,  6, 12,  3,  4,  3,  6,  6,  6,  8,  6, 12, 12, 12, 12, 12, 12,
+    },
+    {   // after consonant
+         2, 10, 12, 12, 12, 12, 12, 10, 12, 12, 12, 12,  6, 12, 12, 11, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12,  8, 12, 12, 12, 12, 12, 12, 11, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,  4, 10,  8,  6,  2,  8,  5,
+         4,  4, 11,  6,  5,  8,  7,  4,  7, 12,  6,  6,  5,  7, 10,  9, 12,  6, 12, 12, 12, 12, 12, 12,
+    },
+    {   // after upper case
+         4, 10, 10, 10, 10, 10, 10,  7, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+        10, 10, 10, 10, 10, 10, 10, 10, 10,  6, 10,  8, 10,  8, 10, 10, 10,  8, 10,  7,  8, 10,  7,  6,
+         5, 10,  7,  5,  6, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,  3, 10,  7, 10,  3,  8, 10,
+         4,  4, 10,  8,  5,  8,  5,  3, 10, 10,  5, 10,  5,  5,  5,  8, 10,  8, 10, 10, 10,  9,  9,  9,
+    },
+    {   // after digit
+         2,  7, 10, 10, 10,  6, 10, 10, 10,  9,  9,  9,  5,  9,  4,  9,  3,  5,  4,  6,  5,  4,  5,  4,
+         6,  7,  5,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+         9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+         9,  9,  9,  9,  9,  7,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+    },
+    {   // after other
+         1,  9,  9,  9,  9,  9,  9,  9,  9,  6,  9,  9,  6,  9,  9,  9,  6,  5,  5,  5,  5,  5,  9,  9,
+         5,  6,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+         9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+         6,  9,  9,  9,  6,  6,  9,  9,  9,  9,  9,  9,  5,  9,  9,  9,  9,  8,  8,  8,  8,  8,  8,  8,
+    },
+};
+
+// Symbols in canonical order (by length, then value) per context
+constexpr uint8_t meshxt_entropy_sorted[MESHXT_ENTROPY_CONTEXTS][MESHXT_ENTROPY_SYMBOLS] = {
+    {
+        84, 65, 67, 51, 66, 70, 72, 73, 77, 78, 79, 82, 83, 87, 17, 18, 33, 34, 35, 38, 39, 50, 52, 55,
+        68, 71, 76, 80, 85, 89, 13, 19, 20, 21, 23, 37, 40, 41, 44, 45, 46, 47, 48, 69, 75, 22, 24, 36,
+        86, 26, 53, 54, 57, 74, 81, 90,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 14, 15, 16,
+        25, 27, 28, 29, 30, 31, 32, 42, 43, 49, 56, 58, 59, 60, 61, 62, 63, 64, 88, 91, 92, 93, 94, 95,
+    },
+    {
+         0, 78, 82, 84, 68, 76, 83, 65, 67, 73, 77, 69, 70, 71, 79, 80, 85, 86, 87, 89, 12, 75, 66, 88,
+        26, 31, 72,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22,
+        23, 24, 25, 27, 28, 29, 30, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48,
+        49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 74, 81, 90, 91, 92, 93, 94, 95,
+    },
+    {
+         0, 69, 65, 72, 73, 79, 71, 76, 84, 12, 68, 75, 82, 83, 89, 78, 80, 85, 31, 67, 70, 77, 87,  1,
+         7, 66, 86, 15, 38, 74,  2,  3,  4,  5,  6,  8,  9, 10, 11, 13, 14, 16, 17, 18, 19, 20, 21, 22,
+        23, 24, 25, 26, 27, 28, 29, 30, 32, 33, 34, 35, 36, 37, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48,
+        49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 81, 88, 90, 91, 92, 93, 94, 95,
+    },
+    {
+        65, 69, 79,  0, 72, 73, 48, 51, 76, 78, 82, 84, 85, 86, 33, 47, 52,  7, 43, 46, 50, 67, 35, 37,
+        41, 44, 70, 75, 77, 87, 89, 93, 94, 95,  1,  2,  3,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, 15,
+        16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 34, 36, 38, 39, 40, 42, 45,
+        49, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 66, 68, 71, 74, 80, 81, 83, 88, 90, 91, 92,
+    },
+    {
+         0, 16, 14, 18, 21, 23, 12, 17, 20, 22, 26,  5, 19, 24,  1, 25, 77,  9, 10, 11, 13, 15, 27, 28,
+        29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52,
+        53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76,
+        78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95,  2,  3,  4,  6,  7,  8,
+    },
+    {
+         0, 17, 18, 19, 20, 21, 24, 84,  9, 12, 16, 25, 72, 76, 77, 89, 90, 91, 92, 93, 94, 95,  1,  2,
+         3,  4,  5,  6,  7,  8, 10, 11, 13, 14, 15, 22, 23, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36,
+        37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60,
+        61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 73, 74, 75, 78, 79, 80, 81, 82, 83, 85, 86, 87, 88,
+    },
+};
@@ -1,35 +1,38 @@
 #include "MeshXTFEC.h"
+#include "MeshXTGF.h"
+#include "MeshXTFECKernels.h"
 #include <string.h>
 
 /**
  * Reed-Solomon over GF(2^8) with primitive polynomial 0x11D
  *
  * Compact implementation suitable for ESP32/nRF52.
- * Uses 512+256 bytes for exp/log tables.
+ * The 512+256 byte exp/log tables and the generator polynomials for
+ * each FEC level are built at compile time (see MeshXTGF.h) and live
+ * in flash, so there is nothing to initialise and no RAM cost.
  */
 
-#define GF_SIZE 256
-#define PRIM_POLY 0x11D
+constexpr MeshXTGFTables meshxt_gf =
+    meshxt_gf_build_tables(MeshXTMakeSeq<512>::type(), MeshXTMakeSeq<256>::type());
 
-static uint8_t gf_exp[512];
-static uint8_t gf_log[256];
-static bool fec_initialized = false;
+static_assert(meshxt_gf_poly_nonzero(meshxt_gf_generator(MESHXT_FEC_LOW), MESHXT_FEC_LOW) &&
+              meshxt_gf_poly_nonzero(meshxt_gf_generator(MESHXT_FEC_MEDIUM), MESHXT_FEC_MEDIUM) &&
+              meshxt_gf_poly_nonzero(meshxt_gf_generator(MESHXT_FEC_HIGH), MESHXT_FEC_HIGH),
+              "generator coefficients must be nonzero to be stored in log form");
 
-void meshxt_fec_init(void) {
-    if (fec_initialized) return;
+constexpr MeshXTGFGenerators meshxt_gf_gen =
+    meshxt_gf_build_generators(meshxt_gf_generator(MESHXT_FEC_LOW),
+                               meshxt_gf_generator(MESHXT_FEC_MEDIUM),
+                               meshxt_gf_generator(MESHXT_FEC_HIGH),
+                               MeshXTMakeSeq<MESHXT_FEC_LOW>::type(),
+                               MeshXTMakeSeq<MESHXT_FEC_MEDIUM>::type(),
+                               MeshXTMakeSeq<MESHXT_FEC_HIGH>::type());
 
-    int x = 1;
-    for (int i = 0; i < 255; i++) {
-        gf_exp[i] = (uint8_t)x;
-        gf_log[x] = (uint8_t)i;
-        x <<= 1;
-        if (x & 0x100) x ^= PRIM_POLY;
-    }
-    for (int i = 255; i < 512; i++) {
-        gf_exp[i] = gf_exp[i - 255];
-    }
+static const uint8_t (&gf_exp)[512] = meshxt_gf.exp;
+static const uint8_t (&gf_log)[256] = meshxt_gf.log;
 
-    fec_initialized = true;
+void meshxt_fec_init(void) {
+    // Tables are compile-time constants; kept for API compatibility.
 }
 
 static inline uint8_t gf_mul(uint8_t a, uint8_t b) {
@@ -42,41 +45,41 @@ static inline uint8_t gf_div(uint8_t a, uint8_t b) {
     return gf_exp[(gf_log[a] + 255 - gf_log[b]) % 255];
 }
 
+static const uint8_t *rs_generator_log(uint8_t nsym) {
+    switch (nsym) {
+        case MESHXT_FEC_LOW:    return meshxt_gf_gen.low;
+        case MESHXT_FEC_MEDIUM: return meshxt_gf_gen.medium;
+        case MESHXT_FEC_HIGH:   return meshxt_gf_gen.high;
+        default:                return NULL;
+    }
+}
+
 /**
  * Compute RS parity symbols.
- * Generator polynomial built on the fly to save RAM.
- * g(x) = (x - alpha^0)(x - alpha^1)...(x - alpha^(nsym-1))
- * Coefficients stored with gen[0] = x^nsym coefficient (always 1)
+ * g(x) = (x - alpha^0)(x - alpha^1)...(x - alpha^(nsym-1)), precomputed
+ * in log form so each feedback byte costs one log lookup plus nsym
+ * exp lookups, with no zero-operand branches.
  */
-static void rs_encode(const uint8_t *msg, size_t msgLen, uint8_t *parity, uint8_t nsym) {
-    // Build generator polynomial
-    uint8_t gen[65]; // max nsym = 64, so gen has nsym+1 coefficients
-    memset(gen, 0, sizeof(gen));
-    gen[0] = 1;
-    int genLen = 1;
-
-    for (int i = 0; i < nsym; i++) {
-        // Multiply gen by (x - alpha^i)
-        // New polynomial has genLen+1 coefficients
-        for (int j = genLen; j > 0; j--) {
-            gen[j] = gen[j - 1] ^ gf_mul(gen[j], gf_exp[i]);
-        }
-        gen[0] = gf_mul(gen[0], gf_exp[i]);
-        genLen++;
-    }
+static void rs_encode_scalar(const uint8_t *msg, size_t msgLen, uint8_t *parity, uint8_t nsym) {
+    const uint8_t *genLog = rs_generator_log(nsym);
 
     // Systematic encoding: compute remainder of msg(x) * x^nsym mod gen(x)
     // Using feedback shift register
-    uint8_t reg[65];
+    uint8_t reg[64];
     memset(reg, 0, nsym);
 
     for (size_t i = 0; i < msgLen; i++) {
         uint8_t feedback = msg[i] ^ reg[0];
-        // Shift register
+        if (feedback == 0) {
+            memmove(reg, reg + 1, nsym - 1);
+            reg[nsym - 1] = 0;
+            continue;
+        }
+        uint8_t fbLog = gf_log[feedback];
         for (int j = 0; j < nsym - 1; j++) {
-            reg[j] = reg[j + 1] ^ gf_mul(gen[nsym - 1 - j], feedback);
+            reg[j] = reg[j + 1] ^ gf_exp[genLog[j] + fbLog];
         }
-        reg[nsym - 1] = gf_mul(gen[0], feedback);
+        reg[nsym - 1] = gf_exp[genLog[nsym - 1] + fbLog];
     }
 
     // Parity is the register contents
@@ -84,19 +87,93 @@ static void rs_encode(const uint8_t *msg, size_t msgLen, uint8_t *parity, uint8_
 }
 
 /**
- * Calculate syndromes.
+ * Calculate syndromes S_first .. S_(first+count-1) into synd[0 .. count-1].
  * S_i = P(alpha^i) where P is the received polynomial.
- * Using Horner's method: result = (...((msg[0] * x + msg[1]) * x + msg[2]) * x + ...)
+ *
+ * Single pass: every received byte is read once and folded into all
+ * count Horner accumulators (acc_i = acc_i * alpha^i + byte), which sit
+ * in one contiguous 64-byte block instead of re-walking the codeword
+ * once per syndrome.
  */
-static void rs_syndromes(const uint8_t *msg, size_t len, uint8_t nsym, uint8_t *synd) {
-    for (int i = 0; i < nsym; i++) {
-        uint8_t val = 0;
-        uint8_t alpha_i = gf_exp[i];
-        for (size_t j = 0; j < len; j++) {
-            val = gf_mul(val, alpha_i) ^ msg[j];
+static void rs_syndromes_scalar(const uint8_t *msg, size_t len, uint8_t first, uint8_t count,
+                                uint8_t *synd) {
+    uint8_t acc[64];
+    memset(acc, 0, count);
+
+    for (size_t j = 0; j < len; j++) {
+        uint8_t b = msg[j];
+        for (int k = 0; k < count; k++) {
+            uint8_t a = acc[k];
+            acc[k] = (a ? gf_exp[gf_log[a] + first + k] : 0) ^ b;
         }
-        synd[i] = val;
     }
+
+    memcpy(synd, acc, count);
+}
+
+// ------------------------------------------------------------
+// Backend dispatch: vector kernels on host CPUs, scalar everywhere else
+// ------------------------------------------------------------
+
+#if MESHXT_FEC_SIMD
+static bool fec_forced = false;
+static const MeshXTFECKernels *fec_forced_kernels = NULL;  // NULL = scalar
+
+static const MeshXTFECKernels *fec_kernels(void) {
+    static const MeshXTFECKernels *detected = meshxt_fec_simd_kernels(MESHXT_FEC_BACKEND_AUTO);
+    return fec_forced ? fec_forced_kernels : detected;
+}
+#endif
+
+bool meshxt_fec_set_backend(uint8_t backend) {
+#if MESHXT_FEC_SIMD
+    if (backend == MESHXT_FEC_BACKEND_AUTO || backend == MESHXT_FEC_BACKEND_SCALAR) {
+        fec_forced = (backend == MESHXT_FEC_BACKEND_SCALAR);
+        fec_forced_kernels = NULL;
+        return true;
+    }
+    const MeshXTFECKernels *k = meshxt_fec_simd_kernels(backend);
+    if (!k) return false;
+    fec_forced = true;
+    fec_forced_kernels = k;
+    return true;
+#else
+    return backend == MESHXT_FEC_BACKEND_AUTO || backend == MESHXT_FEC_BACKEND_SCALAR;
+#endif
+}
+
+const char *meshxt_fec_backend_name(void) {
+#if MESHXT_FEC_SIMD
+    const MeshXTFECKernels *k = fec_kernels();
+    if (k) return k->name;
+#endif
+    return "scalar";
+}
+
+static void rs_encode(const uint8_t *msg, size_t msgLen, uint8_t *parity, uint8_t nsym) {
+#if MESHXT_FEC_SIMD
+    const MeshXTFECKernels *k = fec_kernels();
+    if (k) {
+        k->encode(msg, msgLen, parity, nsym);
+        return;
+    }
+#endif
+    rs_encode_scalar(msg, msgLen, parity, nsym);
+}
+
+static void rs_syndromes(const uint8_t *msg, size_t len, uint8_t first, uint8_t count, uint8_t *synd) {
+#if MESHXT_FEC_SIMD
+    const MeshXTFECKernels *k = fec_kernels();
+    if (k) {
+        k->syndromes(msg, len, first, count, synd);
+        return;
+    }
+#endif
+    rs_syndromes_scalar(msg, len, first, count, synd);
+}
+
+void meshxt_fec_syndromes(const uint8_t *msg, size_t len, uint8_t nsym, uint8_t *synd) {
+    rs_syndromes(msg, len, 0, nsym, synd);
 }
 
 /**
@@ -109,36 +186,220 @@ static bool rs_check(const uint8_t *synd, uint8_t nsym) {
     return true;
 }
 
-int meshxt_fec_encode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym) {
-    meshxt_fec_init();
+/**
+ * Syndromes with an early clean check.
+ *
+ * Most frames arrive intact, so the first MESHXT_FEC_CLEAN_PROBE
+ * syndromes are computed on their own. If they are all zero the frame is
+ * accepted without computing the rest: an error pattern of weight
+ * <= probe can never zero that many consecutive syndromes, and heavier
+ * random patterns do so with probability ~2^(-8 * probe). Otherwise the
+ * remaining syndromes are filled in for the corrector.
+ *
+ * @return true if the frame is clean
+ */
+static bool rs_syndromes_checked(const uint8_t *msg, size_t len, uint8_t nsym, uint8_t *synd) {
+    uint8_t probe = (MESHXT_FEC_CLEAN_PROBE < nsym) ? MESHXT_FEC_CLEAN_PROBE : nsym;
+
+    rs_syndromes(msg, len, 0, probe, synd);
+    if (rs_check(synd, probe)) return true;
+
+    if (probe < nsym) {
+        rs_syndromes(msg, len, probe, nsym - probe, synd + probe);
+    }
+    return false;
+}
 
+/**
+ * alpha^e for any non-negative exponent.
+ */
+static inline uint8_t gf_pow_alpha(int e) {
+    return gf_exp[e % 255];
+}
+
+/**
+ * Evaluate a polynomial (coefficients low-order first) at alpha^e.
+ */
+static uint8_t rs_poly_eval_alpha(const uint8_t *poly, int deg, int e) {
+    uint8_t val = 0;
+    int step = 0;
+    for (int i = 0; i <= deg; i++) {
+        if (poly[i] != 0) {
+            val ^= gf_exp[(gf_log[poly[i]] + step) % 255];
+        }
+        step = (step + e) % 255;
+    }
+    return val;
+}
+
+/**
+ * Berlekamp-Massey, seeded with the erasure locator so that one pass
+ * yields the combined errata locator Lambda(x) (low-order first).
+ * Returns the locator degree L, or -1 if the errata exceed nsym.
+ */
+static int rs_errata_locator(const uint8_t *synd, uint8_t nsym,
+                             const uint8_t *erasures, uint8_t numErasures,
+                             size_t len, uint8_t *lambda) {
+    uint8_t prev[65];
+    uint8_t tmp[65];
+
+    memset(lambda, 0, 65);
+    lambda[0] = 1;
+
+    // Gamma(x) = prod (1 + X_k x), X_k = alpha^(len - 1 - pos)
+    for (int k = 0; k < numErasures; k++) {
+        uint8_t xk = gf_pow_alpha((int)(len - 1 - erasures[k]));
+        for (int j = k + 1; j > 0; j--) {
+            lambda[j] ^= gf_mul(lambda[j - 1], xk);
+        }
+    }
+
+    memcpy(prev, lambda, sizeof(prev));
+    int L = numErasures;
+    int m = 1;
+    uint8_t b = 1;
+
+    for (int r = numErasures; r < nsym; r++) {
+        // Discrepancy
+        uint8_t delta = synd[r];
+        for (int i = 1; i <= L; i++) {
+            delta ^= gf_mul(lambda[i], synd[r - i]);
+        }
+
+        if (delta == 0) {
+            m++;
+            continue;
+        }
+
+        uint8_t coef = gf_div(delta, b);
+        if (2 * L <= r + numErasures) {
+            memcpy(tmp, lambda, sizeof(tmp));
+            for (int j = 0; j + m <= nsym; j++) {
+                lambda[j + m] ^= gf_mul(coef, prev[j]);
+            }
+            L = r + 1 + numErasures - L;
+            memcpy(prev, tmp, sizeof(prev));
+            b = delta;
+            m = 1;
+        } else {
+            for (int j = 0; j + m <= nsym; j++) {
+                lambda[j + m] ^= gf_mul(coef, prev[j]);
+            }
+            m++;
+        }
+    }
+
+    // 2 * errors + erasures must not exceed the parity budget
+    if (2 * (L - numErasures) + numErasures > nsym) return -1;
+
+    int deg = nsym;
+    while (deg > 0 && lambda[deg] == 0) deg--;
+    if (deg != L) return -1;
+
+    return L;
+}
+
+int meshxt_fec_encode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym) {
     if (dataLen + nsym > 255) return -1;
     if (nsym != MESHXT_FEC_LOW && nsym != MESHXT_FEC_MEDIUM && nsym != MESHXT_FEC_HIGH) return -1;
 
-    memcpy(output, data, dataLen);
-    rs_encode(data, dataLen, output + dataLen, nsym);
+    if (output != data) memmove(output, data, dataLen);
+    rs_encode(output, dataLen, output + dataLen, nsym);
 
     return (int)(dataLen + nsym);
 }
 
-int meshxt_fec_decode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym) {
-    meshxt_fec_init();
+int meshxt_fec_decode_erasures(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym,
+                               const uint8_t *erasures, uint8_t numErasures, uint8_t *corrected) {
+    if (corrected) *corrected = 0;
+    if (nsym == 0 || nsym > MESHXT_FEC_HIGH) return -1;
+    if (dataLen < nsym || dataLen > 255) return -1;
+    if (numErasures > nsym) return -1;
 
-    if (dataLen < nsym) return -1;
+    for (int k = 0; k < numErasures; k++) {
+        if (erasures[k] >= dataLen) return -1;
+        for (int j = 0; j < k; j++) {
+            if (erasures[j] == erasures[k]) return -1;
+        }
+    }
 
-    uint8_t synd[64];
-    rs_syndromes(data, dataLen, nsym, synd);
+    size_t msgLen = dataLen - nsym;
 
-    if (rs_check(synd, nsym)) {
+    uint8_t synd[64];
+    if (rs_syndromes_checked(data, dataLen, nsym, synd)) {
         // No errors — just strip parity
-        size_t msgLen = dataLen - nsym;
-        memcpy(output, data, msgLen);
+        memmove(output, data, msgLen);
         return (int)msgLen;
     }
 
-    // Error correction using Berlekamp-Massey + Chien search + Forney
-    // For firmware v0.1, we detect but don't correct — return -1
-    // Full correction will be added in v0.2
-    // (Clean decode works; corrupted packets are flagged for retransmit)
-    return -1;
+    // 1. Errata locator (Berlekamp-Massey seeded with erasures)
+    uint8_t lambda[65];
+    int L = rs_errata_locator(synd, nsym, erasures, numErasures, dataLen, lambda);
+    if (L <= 0) return -1;
+
+    // 2. Chien search: position p is in error when Lambda(X_p^-1) == 0
+    uint8_t errPos[64];
+    int numErr = 0;
+    for (size_t p = 0; p < dataLen; p++) {
+        int power = (int)(dataLen - 1 - p);
+        if (rs_poly_eval_alpha(lambda, L, (255 - power) % 255) == 0) {
+            if (numErr >= L) return -1;
+            errPos[numErr++] = (uint8_t)p;
+        }
+    }
+    if (numErr != L) return -1;
+
+    // 3. Errata evaluator Omega(x) = S(x) * Lambda(x) mod x^nsym
+    uint8_t omega[64];
+    for (int i = 0; i < nsym; i++) {
+        uint8_t v = 0;
+        for (int j = 0; j <= i && j <= L; j++) {
+            v ^= gf_mul(lambda[j], synd[i - j]);
+        }
+        omega[i] = v;
+    }
+
+    // Formal derivative Lambda'(x): odd terms shifted down one power
+    uint8_t dlambda[64];
+    memset(dlambda, 0, sizeof(dlambda));
+    for (int i = 1; i <= L; i += 2) {
+        dlambda[i - 1] = lambda[i];
+    }
+
+    // 4. Forney: Y = X * Omega(X^-1) / Lambda'(X^-1)  (first root alpha^0)
+    uint8_t errMag[64];
+    for (int k = 0; k < numErr; k++) {
+        int power = (int)(dataLen - 1 - errPos[k]);
+        int inv = (255 - power) % 255;
+        uint8_t num = rs_poly_eval_alpha(omega, nsym - 1, inv);
+        uint8_t den = rs_poly_eval_alpha(dlambda, L - 1, inv);
+        if (den == 0) return -1;
+        errMag[k] = gf_mul(gf_pow_alpha(power), gf_div(num, den));
+    }
+
+    // 5. Verify the correction reproduces every syndrome before trusting it
+    for (int i = 0; i < nsym; i++) {
+        uint8_t s = 0;
+        for (int k = 0; k < numErr; k++) {
+            if (errMag[k] == 0) continue;
+            int power = (int)(dataLen - 1 - errPos[k]);
+            s ^= gf_mul(errMag[k], gf_pow_alpha(power * i));
+        }
+        if (s != synd[i]) return -1;
+    }
+
+    memmove(output, data, msgLen);
+    uint8_t fixed = 0;
+    for (int k = 0; k < numErr; k++) {
+        if (errMag[k] == 0) continue;
+        if (errPos[k] < msgLen) output[errPos[k]] ^= errMag[k];
+        fixed++;
+    }
+
+    if (corrected) *corrected = fixed;
+    return (int)msgLen;
+}
+
+int meshxt_fec_decode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym) {
+    return meshxt_fec_decode_erasures(data, dataLen, output, nsym, NULL, 0, NULL);
 }
@@ -18,18 +18,46 @@
 #define MESHXT_FEC_MEDIUM 32
 #define MESHXT_FEC_HIGH   64
 
+// Syndromes checked before a frame is accepted as error-free (1..64).
+// Frames that fail the probe get the full set computed and corrected.
+#ifndef MESHXT_FEC_CLEAN_PROBE
+#define MESHXT_FEC_CLEAN_PROBE 8
+#endif
+
+// Codec backends (see meshxt_fec_set_backend)
+#define MESHXT_FEC_BACKEND_AUTO   0   // Fastest kernels the CPU supports
+#define MESHXT_FEC_BACKEND_SCALAR 1   // Portable table-lookup loops
+#define MESHXT_FEC_BACKEND_SSSE3  2   // x86 SSSE3 kernels
+#define MESHXT_FEC_BACKEND_AVX2   3   // x86 AVX2 kernels
+#define MESHXT_FEC_BACKEND_NEON   4   // ARM NEON kernels
+
 /**
- * Initialise GF(2^8) lookup tables. Call once at startup.
- * Safe to call multiple times (idempotent).
+ * No-op. GF(2^8) tables and generator polynomials are compile-time
+ * constants in flash; kept so existing callers still link.
  */
 void meshxt_fec_init(void);
 
+/**
+ * Select the codec backend. On x86 (SSSE3/AVX2) and ARM NEON hosts the
+ * vector kernels are picked at runtime; microcontroller builds only have
+ * the scalar path. All backends produce bit-identical output.
+ * A specific kernel set can be forced for cross-checking and timing.
+ * @return false, leaving the backend as it was, if that kernel set is
+ *         not compiled in or the CPU lacks it
+ */
+bool meshxt_fec_set_backend(uint8_t backend);
+
+/**
+ * Name of the active backend ("scalar", "ssse3", "avx2" or "neon").
+ */
+const char *meshxt_fec_backend_name(void);
+
 /**
  * Encode data with Reed-Solomon parity.
  *
  * @param data     Input data
  * @param dataLen  Length of input data
- * @param output   Output buffer (must be at least dataLen + nsym bytes)
+ * @param output   Output buffer (must be at least dataLen + nsym bytes; may alias data)
  * @param nsym     Number of parity symbols (16, 32, or 64)
  * @return         Total output length (dataLen + nsym), or -1 on error
  */
@@ -45,3 +73,22 @@ int meshxt_fec_encode(const uint8_t *data, size_t dataLen, uint8_t *output, uint
  * @return         Message length (dataLen - nsym), or -1 if uncorrectable
  */
 int meshxt_fec_decode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym);
+
+/**
+ * Decode with erasure information (Berlekamp-Massey + Chien + Forney).
+ *
+ * Corrects any combination of e errors and f erasures with 2e + f <= nsym,
+ * i.e. up to nsym/2 unknown errors or nsym known-bad symbols. Uses only
+ * fixed stack buffers. output may alias data for in-place decoding.
+ *
+ * @param data         Input data with parity appended
+ * @param dataLen      Total length (message + parity), at most 255
+ * @param output       Output buffer for corrected message (parity stripped)
+ * @param nsym         Number of parity symbols used during encoding
+ * @param erasures     Byte offsets into data known to be unreliable (may be NULL)
+ * @param numErasures  Number of entries in erasures (at most nsym)
+ * @param corrected    Set to the number of symbols repaired (may be NULL)
+ * @return             Message length (dataLen - nsym), or -1 if uncorrectable
+ */
+int meshxt_fec_decode_erasures(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym,
+                               const uint8_t *erasures, uint8_t numErasures, uint8_t *corrected);
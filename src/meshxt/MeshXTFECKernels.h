@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Internal: vectorised Reed-Solomon kernels (split-nibble GF multiply).
+ *
+ * Built only for host-class CPUs (x86 SSSE3/AVX2, ARM NEON), i.e. Linux
+ * ground decoders and Raspberry Pi gateways. ESP32/nRF52 builds compile
+ * none of this and use the scalar loops in MeshXTFEC.cpp directly.
+ * Define MESHXT_FEC_SIMD=0 to force the scalar path everywhere, or
+ * MESHXT_FEC_NO_AVX2 to stop at SSSE3 on x86.
+ */
+
+#ifndef MESHXT_FEC_SIMD
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__) || defined(__ARM_NEON)
+#define MESHXT_FEC_SIMD 1
+#else
+#define MESHXT_FEC_SIMD 0
+#endif
+#endif
+
+struct MeshXTFECKernels {
+    const char *name;
+
+    // synd[k] = R(alpha^(first+k)) for k < count; first + count <= 64, len <= 255
+    void (*syndromes)(const uint8_t *msg, size_t len, uint8_t first, uint8_t count, uint8_t *synd);
+
+    // Parity for nsym = 16, 32 or 64; identical to the scalar LFSR
+    void (*encode)(const uint8_t *msg, size_t msgLen, uint8_t *parity, uint8_t nsym);
+};
+
+/**
+ * Syndromes through the active backend (exposed for cross-checking).
+ */
+void meshxt_fec_syndromes(const uint8_t *msg, size_t len, uint8_t nsym, uint8_t *synd);
+
+#if MESHXT_FEC_SIMD
+/**
+ * Kernel set for a MESHXT_FEC_BACKEND_* value: the best one the running
+ * CPU supports for AUTO, else the one named. NULL if it is not built for
+ * this architecture or the CPU lacks it.
+ */
+const MeshXTFECKernels *meshxt_fec_simd_kernels(uint8_t backend);
+#endif
@@ -0,0 +1,529 @@
+#include "MeshXTFECKernels.h"
+
+#if MESHXT_FEC_SIMD
+
+#include "MeshXTFEC.h"
+#include "MeshXTGF.h"
+#include <string.h>
+
+/**
+ * Split-nibble GF(2^8) kernels.
+ *
+ * A product c * x for a fixed c is linear over GF(2), so it splits into
+ * c * (x & 0x0F) ^ c * (x & 0xF0): two 16-entry tables, each one byte
+ * shuffle (PSHUFB / TBL) over a whole vector of x.
+ *
+ * Syndromes: S_i = sum_j r_j * beta^e, beta = alpha^i, e = n-1-j. Lane i
+ * holds S_i, so one pass over the codeword accumulates all of them: byte
+ * r_j picks the split tables for c = r_j and the row [alpha^(i*e)] is the
+ * vector of x, one shuffle pair per byte and W syndromes.
+ *
+ * A few syndromes (the clean probe) leave most lanes idle, so they go
+ * the other way round. The codeword is right-aligned in a zero-padded
+ * buffer of W-byte blocks and each lane runs its own Horner chain with
+ * the shared constant beta^W, so one shuffle pair advances W positions.
+ * Lane l then carries weight beta^(W-1-l); halving folds (lane l *
+ * beta^(W/2) ^ lane l + W/2) bring that down to a single lane in log2(W)
+ * more shuffle pairs. That is a pass per syndrome, but the cheaper one
+ * up to SIMD_SYND_FEW of them.
+ *
+ * Encoding: the LFSR register (nsym bytes) lives in vector registers.
+ * Each step multiplies the whole generator by the scalar feedback; for
+ * that we keep, per nibble value v, the vector [g_k * v] (and [g_k * v<<4]),
+ * so the product is two vector loads and an XOR, followed by a one-byte
+ * register shift (PALIGNR / EXT).
+ */
+
+// ------------------------------------------------------------
+// Compile-time tables
+// ------------------------------------------------------------
+
+// Per syndrome i: [c * k] for k < 16, then [c * (k << 4)], c = alpha^(W*i)
+struct MeshXTSyndTables {
+    uint8_t t[64 * 32];
+};
+
+constexpr uint8_t simd_synd_entry(int stride, int k) {
+    return meshxt_gf_mul_slow(meshxt_gf_exp_at((stride * (k / 32)) % 255),
+                              (k % 32) < 16 ? (unsigned)(k % 16) : (unsigned)((k % 16) << 4));
+}
+
+template<int... K>
+constexpr MeshXTSyndTables simd_build_synd(int stride, MeshXTSeq<K...>) {
+    return MeshXTSyndTables{ { simd_synd_entry(stride, K)... } };
+}
+
+// Row c: [c * k] for k < 16, then [c * (k << 4)]
+struct MeshXTMulTables {
+    uint8_t t[256 * 32];
+};
+
+constexpr uint8_t simd_mul_entry(int k) {
+    return meshxt_gf_mul_slow((unsigned)(k / 32),
+                              (k % 32) < 16 ? (unsigned)(k % 16) : (unsigned)((k % 16) << 4));
+}
+
+template<int... K>
+constexpr MeshXTMulTables simd_build_mul(MeshXTSeq<K...>) {
+    return MeshXTMulTables{ { simd_mul_entry(K)... } };
+}
+
+// Row e: [alpha^(i*e)] for i < 64, the weights of a byte e places from the end
+struct MeshXTWeightTables {
+    uint8_t t[255 * 64];
+};
+
+constexpr uint8_t simd_weight_entry(int k) {
+    return meshxt_gf_exp_at((k / 64) * (k % 64) % 255);
+}
+
+template<int... K>
+constexpr MeshXTWeightTables simd_build_weights(MeshXTSeq<K...>) {
+    return MeshXTWeightTables{ { simd_weight_entry(K)... } };
+}
+
+// Row v < 16: [g_(nsym-1-j) * v]; row 16 + v: [g_(nsym-1-j) * (v << 4)]
+template<int NSYM>
+struct MeshXTEncTables {
+    uint8_t t[32 * NSYM];
+};
+
+template<int NSYM>
+constexpr uint8_t simd_enc_entry(MeshXTGFPoly g, int k) {
+    return meshxt_gf_mul_slow(g.c[NSYM - 1 - (k % NSYM)],
+                              (k / NSYM) < 16 ? (unsigned)(k / NSYM) : (unsigned)((k / NSYM - 16) << 4));
+}
+
+template<int NSYM, int... K>
+constexpr MeshXTEncTables<NSYM> simd_build_enc(MeshXTGFPoly g, MeshXTSeq<K...>) {
+    return MeshXTEncTables<NSYM>{ { simd_enc_entry<NSYM>(g, K)... } };
+}
+
+// Split tables for alpha^(W*i), W = 32, 16, 8, 4, 2, 1
+enum { SYND_W32, SYND_W16, SYND_W8, SYND_W4, SYND_W2, SYND_W1 };
+
+alignas(32) static constexpr MeshXTSyndTables synd_pow[6] = {
+    simd_build_synd(32, MeshXTMakeSeq<64 * 32>::type()),
+    simd_build_synd(16, MeshXTMakeSeq<64 * 32>::type()),
+    simd_build_synd(8,  MeshXTMakeSeq<64 * 32>::type()),
+    simd_build_synd(4,  MeshXTMakeSeq<64 * 32>::type()),
+    simd_build_synd(2,  MeshXTMakeSeq<64 * 32>::type()),
+    simd_build_synd(1,  MeshXTMakeSeq<64 * 32>::type()),
+};
+
+alignas(32) static constexpr MeshXTMulTables synd_mul = simd_build_mul(MeshXTMakeSeq<256 * 32>::type());
+alignas(32) static constexpr MeshXTWeightTables synd_weights =
+    simd_build_weights(MeshXTMakeSeq<255 * 64>::type());
+
+alignas(32) static constexpr MeshXTEncTables<MESHXT_FEC_LOW> enc16 =
+    simd_build_enc<MESHXT_FEC_LOW>(meshxt_gf_generator(MESHXT_FEC_LOW),
+                                   MeshXTMakeSeq<32 * MESHXT_FEC_LOW>::type());
+alignas(32) static constexpr MeshXTEncTables<MESHXT_FEC_MEDIUM> enc32 =
+    simd_build_enc<MESHXT_FEC_MEDIUM>(meshxt_gf_generator(MESHXT_FEC_MEDIUM),
+                                      MeshXTMakeSeq<32 * MESHXT_FEC_MEDIUM>::type());
+alignas(32) static constexpr MeshXTEncTables<MESHXT_FEC_HIGH> enc64 =
+    simd_build_enc<MESHXT_FEC_HIGH>(meshxt_gf_generator(MESHXT_FEC_HIGH),
+                                    MeshXTMakeSeq<32 * MESHXT_FEC_HIGH>::type());
+
+/**
+ * Right-align the codeword in a zero-padded buffer of whole blocks.
+ * Leading zeros do not change R(x). Returns the number of blocks.
+ */
+static size_t simd_pad_blocks(const uint8_t *msg, size_t len, uint8_t *buf, size_t width) {
+    size_t nblk = (len + width - 1) / width;
+    size_t pad = nblk * width - len;
+    memset(buf, 0, pad);
+    memcpy(buf + pad, msg, len);
+    return nblk;
+}
+
+// Up to this many syndromes, a block pass per syndrome beats a lane each
+#define SIMD_SYND_FEW 8
+
+/**
+ * Lane-per-syndrome kernels work on whole W-lane vectors from an aligned
+ * base; the caller's S_first .. S_(first+count-1) are copied out of that.
+ * Returns the number of vectors.
+ */
+static int simd_synd_span(uint8_t first, uint8_t count, int width, int &base) {
+    base = first / width * width;
+    return (first + count + width - 1) / width - first / width;
+}
+
+// ------------------------------------------------------------
+// x86: SSSE3 / AVX2
+// ------------------------------------------------------------
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define MESHXT_SSSE3 __attribute__((target("ssse3")))
+#define MESHXT_AVX2  __attribute__((target("avx2")))
+
+MESHXT_SSSE3 static inline __m128i ssse3_mul(__m128i x, __m128i lo, __m128i hi, __m128i mask) {
+    __m128i l = _mm_shuffle_epi8(lo, _mm_and_si128(x, mask));
+    __m128i h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi64(x, 4), mask));
+    return _mm_xor_si128(l, h);
+}
+
+MESHXT_SSSE3 static inline __m128i ssse3_mul_by(__m128i x, int table, int i, __m128i mask) {
+    const uint8_t *tbl = synd_pow[table].t + i * 32;
+    return ssse3_mul(x, _mm_load_si128((const __m128i *)tbl),
+                     _mm_load_si128((const __m128i *)(tbl + 16)), mask);
+}
+
+// 16 lanes with weights beta^(15-l) -> S_i
+MESHXT_SSSE3 static inline uint8_t ssse3_fold16(__m128i acc, int i, __m128i mask) {
+    acc = _mm_xor_si128(ssse3_mul_by(acc, SYND_W8, i, mask), _mm_srli_si128(acc, 8));
+    acc = _mm_xor_si128(ssse3_mul_by(acc, SYND_W4, i, mask), _mm_srli_si128(acc, 4));
+    acc = _mm_xor_si128(ssse3_mul_by(acc, SYND_W2, i, mask), _mm_srli_si128(acc, 2));
+    acc = _mm_xor_si128(ssse3_mul_by(acc, SYND_W1, i, mask), _mm_srli_si128(acc, 1));
+    return (uint8_t)_mm_cvtsi128_si32(acc);
+}
+
+MESHXT_SSSE3 static void ssse3_syndromes_few(const uint8_t *msg, size_t len, uint8_t first, uint8_t count,
+                                     uint8_t *synd) {
+    alignas(16) uint8_t buf[256];
+    size_t nblk = simd_pad_blocks(msg, len, buf, 16);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    for (int i = first; i < first + count; i++) {
+        const uint8_t *tbl = synd_pow[SYND_W16].t + i * 32;
+        __m128i lo = _mm_load_si128((const __m128i *)tbl);
+        __m128i hi = _mm_load_si128((const __m128i *)(tbl + 16));
+        __m128i acc = _mm_load_si128((const __m128i *)buf);
+        for (size_t b = 1; b < nblk; b++) {
+            acc = _mm_xor_si128(ssse3_mul(acc, lo, hi, mask),
+                                _mm_load_si128((const __m128i *)(buf + b * 16)));
+        }
+        synd[i - first] = ssse3_fold16(acc, i, mask);
+    }
+}
+
+// N vectors of 16 syndromes from S_base
+template<int N>
+MESHXT_SSSE3 static void ssse3_syndromes_n(const uint8_t *msg, size_t len, int base, uint8_t *out) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    __m128i acc[N];
+    for (int k = 0; k < N; k++) acc[k] = _mm_setzero_si128();
+
+    for (size_t j = 0; j < len; j++) {
+        const uint8_t *m = synd_mul.t + msg[j] * 32;
+        const uint8_t *w = synd_weights.t + (len - 1 - j) * 64 + base;
+        __m128i lo = _mm_load_si128((const __m128i *)m);
+        __m128i hi = _mm_load_si128((const __m128i *)(m + 16));
+        for (int k = 0; k < N; k++) {
+            __m128i x = _mm_load_si128((const __m128i *)(w + k * 16));
+            acc[k] = _mm_xor_si128(acc[k], ssse3_mul(x, lo, hi, mask));
+        }
+    }
+
+    for (int k = 0; k < N; k++) {
+        _mm_store_si128((__m128i *)(out + k * 16), acc[k]);
+    }
+}
+
+MESHXT_SSSE3 static void ssse3_syndromes(const uint8_t *msg, size_t len, uint8_t first, uint8_t count,
+                                 uint8_t *synd) {
+    if (count <= SIMD_SYND_FEW) {
+        ssse3_syndromes_few(msg, len, first, count, synd);
+        return;
+    }
+    alignas(16) uint8_t out[64];
+    int base;
+    switch (simd_synd_span(first, count, 16, base)) {
+        case 2: ssse3_syndromes_n<2>(msg, len, base, out); break;
+        case 3: ssse3_syndromes_n<3>(msg, len, base, out); break;
+        case 4: ssse3_syndromes_n<4>(msg, len, base, out); break;
+        default: ssse3_syndromes_n<1>(msg, len, base, out); break;
+    }
+    memcpy(synd, out + (first - base), count);
+}
+
+template<int N>
+MESHXT_SSSE3 static void ssse3_encode_n(const uint8_t *msg, size_t msgLen, uint8_t *parity,
+                                        const uint8_t *tbl) {
+    const int nsym = N * 16;
+    __m128i r[N];
+    for (int k = 0; k < N; k++) r[k] = _mm_setzero_si128();
+
+    for (size_t i = 0; i < msgLen; i++) {
+        uint8_t feedback = msg[i] ^ (uint8_t)_mm_cvtsi128_si32(r[0]);
+        const uint8_t *plo = tbl + (feedback & 0x0F) * nsym;
+        const uint8_t *phi = tbl + (16 + (feedback >> 4)) * nsym;
+        for (int k = 0; k < N; k++) {
+            __m128i next = (k + 1 < N) ? r[k + 1] : _mm_setzero_si128();
+            __m128i shifted = _mm_alignr_epi8(next, r[k], 1);
+            __m128i prod = _mm_xor_si128(_mm_load_si128((const __m128i *)(plo + k * 16)),
+                                         _mm_load_si128((const __m128i *)(phi + k * 16)));
+            r[k] = _mm_xor_si128(shifted, prod);
+        }
+    }
+
+    for (int k = 0; k < N; k++) {
+        _mm_storeu_si128((__m128i *)(parity + k * 16), r[k]);
+    }
+}
+
+MESHXT_SSSE3 static void ssse3_encode(const uint8_t *msg, size_t msgLen, uint8_t *parity, uint8_t nsym) {
+    switch (nsym) {
+        case MESHXT_FEC_LOW:    ssse3_encode_n<1>(msg, msgLen, parity, enc16.t); break;
+        case MESHXT_FEC_MEDIUM: ssse3_encode_n<2>(msg, msgLen, parity, enc32.t); break;
+        case MESHXT_FEC_HIGH:   ssse3_encode_n<4>(msg, msgLen, parity, enc64.t); break;
+    }
+}
+
+MESHXT_AVX2 static inline __m256i avx2_mul(__m256i x, __m256i lo, __m256i hi, __m256i mask) {
+    __m256i l = _mm256_shuffle_epi8(lo, _mm256_and_si256(x, mask));
+    __m256i h = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi64(x, 4), mask));
+    return _mm256_xor_si256(l, h);
+}
+
+MESHXT_AVX2 static void avx2_syndromes_few(const uint8_t *msg, size_t len, uint8_t first, uint8_t count,
+                                    uint8_t *synd) {
+    alignas(32) uint8_t buf[256];
+    size_t nblk = simd_pad_blocks(msg, len, buf, 32);
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    const __m128i mask128 = _mm_set1_epi8(0x0F);
+
+    for (int i = first; i < first + count; i++) {
+        const uint8_t *tbl = synd_pow[SYND_W32].t + i * 32;
+        __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)tbl));
+        __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)(tbl + 16)));
+        __m256i acc = _mm256_load_si256((const __m256i *)buf);
+        for (size_t b = 1; b < nblk; b++) {
+            acc = _mm256_xor_si256(avx2_mul(acc, lo, hi, mask),
+                                   _mm256_load_si256((const __m256i *)(buf + b * 32)));
+        }
+        // 32 -> 16 lanes: low half carries the extra beta^16
+        __m128i lo16 = ssse3_mul_by(_mm256_castsi256_si128(acc), SYND_W16, i, mask128);
+        __m128i folded = _mm_xor_si128(lo16, _mm256_extracti128_si256(acc, 1));
+        synd[i - first] = ssse3_fold16(folded, i, mask128);
+    }
+}
+
+// N vectors of 32 syndromes from S_base
+template<int N>
+MESHXT_AVX2 static void avx2_syndromes_n(const uint8_t *msg, size_t len, int base, uint8_t *out) {
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    __m256i acc[N];
+    for (int k = 0; k < N; k++) acc[k] = _mm256_setzero_si256();
+
+    for (size_t j = 0; j < len; j++) {
+        const uint8_t *m = synd_mul.t + msg[j] * 32;
+        const uint8_t *w = synd_weights.t + (len - 1 - j) * 64 + base;
+        __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)m));
+        __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)(m + 16)));
+        for (int k = 0; k < N; k++) {
+            __m256i x = _mm256_load_si256((const __m256i *)(w + k * 32));
+            acc[k] = _mm256_xor_si256(acc[k], avx2_mul(x, lo, hi, mask));
+        }
+    }
+
+    for (int k = 0; k < N; k++) {
+        _mm256_store_si256((__m256i *)(out + k * 32), acc[k]);
+    }
+}
+
+MESHXT_AVX2 static void avx2_syndromes(const uint8_t *msg, size_t len, uint8_t first, uint8_t count,
+                                uint8_t *synd) {
+    if (count <= SIMD_SYND_FEW) {
+        avx2_syndromes_few(msg, len, first, count, synd);
+        return;
+    }
+    alignas(32) uint8_t out[64];
+    int base;
+    if (simd_synd_span(first, count, 32, base) == 2) {
+        avx2_syndromes_n<2>(msg, len, base, out);
+    } else {
+        avx2_syndromes_n<1>(msg, len, base, out);
+    }
+    memcpy(synd, out + (first - base), count);
+}
+
+template<int N>
+MESHXT_AVX2 static void avx2_encode_n(const uint8_t *msg, size_t msgLen, uint8_t *parity,
+                                      const uint8_t *tbl) {
+    const int nsym = N * 32;
+    __m256i r[N];
+    for (int k = 0; k < N; k++) r[k] = _mm256_setzero_si256();
+
+    for (size_t i = 0; i < msgLen; i++) {
+        uint8_t feedback = msg[i] ^ (uint8_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(r[0]));
+        const uint8_t *plo = tbl + (feedback & 0x0F) * nsym;
+        const uint8_t *phi = tbl + (16 + (feedback >> 4)) * nsym;
+        for (int k = 0; k < N; k++) {
+            __m256i next = (k + 1 < N) ? r[k + 1] : _mm256_setzero_si256();
+            // Byte shift across the 128-bit lane boundary: [r.hi, next.lo] supplies the carry-in
+            __m256i carry = _mm256_permute2x128_si256(r[k], next, 0x21);
+            __m256i shifted = _mm256_alignr_epi8(carry, r[k], 1);
+            __m256i prod = _mm256_xor_si256(_mm256_load_si256((const __m256i *)(plo + k * 32)),
+                                            _mm256_load_si256((const __m256i *)(phi + k * 32)));
+            r[k] = _mm256_xor_si256(shifted, prod);
+        }
+    }
+
+    for (int k = 0; k < N; k++) {
+        _mm256_storeu_si256((__m256i *)(parity + k * 32), r[k]);
+    }
+}
+
+MESHXT_AVX2 static void avx2_encode(const uint8_t *msg, size_t msgLen, uint8_t *parity, uint8_t nsym) {
+    switch (nsym) {
+        case MESHXT_FEC_LOW:    ssse3_encode_n<1>(msg, msgLen, parity, enc16.t); break;
+        case MESHXT_FEC_MEDIUM: avx2_encode_n<1>(msg, msgLen, parity, enc32.t); break;
+        case MESHXT_FEC_HIGH:   avx2_encode_n<2>(msg, msgLen, parity, enc64.t); break;
+    }
+}
+
+static const MeshXTFECKernels kernels_ssse3 = { "ssse3", ssse3_syndromes, ssse3_encode };
+static const MeshXTFECKernels kernels_avx2  = { "avx2",  avx2_syndromes,  avx2_encode };
+
+const MeshXTFECKernels *meshxt_fec_simd_kernels(uint8_t backend) {
+    __builtin_cpu_init();
+    bool ssse3 = __builtin_cpu_supports("ssse3");
+#ifndef MESHXT_FEC_NO_AVX2
+    bool avx2 = __builtin_cpu_supports("avx2");
+#else
+    bool avx2 = false;
+#endif
+    switch (backend) {
+        case MESHXT_FEC_BACKEND_AUTO:  return avx2 ? &kernels_avx2 : ssse3 ? &kernels_ssse3 : NULL;
+        case MESHXT_FEC_BACKEND_SSSE3: return ssse3 ? &kernels_ssse3 : NULL;
+        case MESHXT_FEC_BACKEND_AVX2:  return avx2 ? &kernels_avx2 : NULL;
+        default:                       return NULL;
+    }
+}
+
+// ------------------------------------------------------------
+// ARM: NEON (always present on AArch64; 32-bit only when built with -mfpu=neon)
+// ------------------------------------------------------------
+#else
+
+#include <arm_neon.h>
+
+static inline uint8x16_t neon_lookup(uint8x16_t tbl, uint8x16_t idx) {
+#if defined(__aarch64__)
+    return vqtbl1q_u8(tbl, idx);
+#else
+    uint8x8x2_t t = { { vget_low_u8(tbl), vget_high_u8(tbl) } };
+    return vcombine_u8(vtbl2_u8(t, vget_low_u8(idx)), vtbl2_u8(t, vget_high_u8(idx)));
+#endif
+}
+
+static inline uint8x16_t neon_mul(uint8x16_t x, uint8x16_t lo, uint8x16_t hi, uint8x16_t mask) {
+    return veorq_u8(neon_lookup(lo, vandq_u8(x, mask)), neon_lookup(hi, vshrq_n_u8(x, 4)));
+}
+
+static inline uint8x16_t neon_mul_by(uint8x16_t x, int table, int i, uint8x16_t mask) {
+    const uint8_t *tbl = synd_pow[table].t + i * 32;
+    return neon_mul(x, vld1q_u8(tbl), vld1q_u8(tbl + 16), mask);
+}
+
+// 16 lanes with weights beta^(15-l) -> S_i
+static inline uint8_t neon_fold16(uint8x16_t acc, int i, uint8x16_t mask) {
+    const uint8x16_t zero = vdupq_n_u8(0);
+    acc = veorq_u8(neon_mul_by(acc, SYND_W8, i, mask), vextq_u8(acc, zero, 8));
+    acc = veorq_u8(neon_mul_by(acc, SYND_W4, i, mask), vextq_u8(acc, zero, 4));
+    acc = veorq_u8(neon_mul_by(acc, SYND_W2, i, mask), vextq_u8(acc, zero, 2));
+    acc = veorq_u8(neon_mul_by(acc, SYND_W1, i, mask), vextq_u8(acc, zero, 1));
+    return vgetq_lane_u8(acc, 0);
+}
+
+static void neon_syndromes_few(const uint8_t *msg, size_t len, uint8_t first, uint8_t count,
+                               uint8_t *synd) {
+    alignas(16) uint8_t buf[256];
+    size_t nblk = simd_pad_blocks(msg, len, buf, 16);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+
+    for (int i = first; i < first + count; i++) {
+        const uint8_t *tbl = synd_pow[SYND_W16].t + i * 32;
+        uint8x16_t lo = vld1q_u8(tbl);
+        uint8x16_t hi = vld1q_u8(tbl + 16);
+        uint8x16_t acc = vld1q_u8(buf);
+        for (size_t b = 1; b < nblk; b++) {
+            acc = veorq_u8(neon_mul(acc, lo, hi, mask), vld1q_u8(buf + b * 16));
+        }
+        synd[i - first] = neon_fold16(acc, i, mask);
+    }
+}
+
+// N vectors of 16 syndromes from S_base
+template<int N>
+static void neon_syndromes_n(const uint8_t *msg, size_t len, int base, uint8_t *out) {
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    uint8x16_t acc[N];
+    for (int k = 0; k < N; k++) acc[k] = vdupq_n_u8(0);
+
+    for (size_t j = 0; j < len; j++) {
+        const uint8_t *m = synd_mul.t + msg[j] * 32;
+        const uint8_t *w = synd_weights.t + (len - 1 - j) * 64 + base;
+        uint8x16_t lo = vld1q_u8(m);
+        uint8x16_t hi = vld1q_u8(m + 16);
+        for (int k = 0; k < N; k++) {
+            acc[k] = veorq_u8(acc[k], neon_mul(vld1q_u8(w + k * 16), lo, hi, mask));
+        }
+    }
+
+    for (int k = 0; k < N; k++) {
+        vst1q_u8(out + k * 16, acc[k]);
+    }
+}
+
+static void neon_syndromes(const uint8_t *msg, size_t len, uint8_t first, uint8_t count,
+                           uint8_t *synd) {
+    if (count <= SIMD_SYND_FEW) {
+        neon_syndromes_few(msg, len, first, count, synd);
+        return;
+    }
+    alignas(16) uint8_t out[64];
+    int base;
+    switch (simd_synd_span(first, count, 16, base)) {
+        case 2: neon_syndromes_n<2>(msg, len, base, out); break;
+        case 3: neon_syndromes_n<3>(msg, len, base, out); break;
+        case 4: neon_syndromes_n<4>(msg, len, base, out); break;
+        default: neon_syndromes_n<1>(msg, len, base, out); break;
+    }
+    memcpy(synd, out + (first - base), count);
+}
+
+template<int N>
+static void neon_encode_n(const uint8_t *msg, size_t msgLen, uint8_t *parity, const uint8_t *tbl) {
+    const int nsym = N * 16;
+    uint8x16_t r[N];
+    for (int k = 0; k < N; k++) r[k] = vdupq_n_u8(0);
+
+    for (size_t i = 0; i < msgLen; i++) {
+        uint8_t feedback = msg[i] ^ vgetq_lane_u8(r[0], 0);
+        const uint8_t *plo = tbl + (feedback & 0x0F) * nsym;
+        const uint8_t *phi = tbl + (16 + (feedback >> 4)) * nsym;
+        for (int k = 0; k < N; k++) {
+            uint8x16_t next = (k + 1 < N) ? r[k + 1] : vdupq_n_u8(0);
+            uint8x16_t shifted = vextq_u8(r[k], next, 1);
+            r[k] = veorq_u8(shifted, veorq_u8(vld1q_u8(plo + k * 16), vld1q_u8(phi + k * 16)));
+        }
+    }
+
+    for (int k = 0; k < N; k++) {
+        vst1q_u8(parity + k * 16, r[k]);
+    }
+}
+
+static void neon_encode(const uint8_t *msg, size_t msgLen, uint8_t *parity, uint8_t nsym) {
+    switch (nsym) {
+        case MESHXT_FEC_LOW:    neon_encode_n<1>(msg, msgLen, parity, enc16.t); break;
+        case MESHXT_FEC_MEDIUM: neon_encode_n<2>(msg, msgLen, parity, enc32.t); break;
+        case MESHXT_FEC_HIGH:   neon_encode_n<4>(msg, msgLen, parity, enc64.t); break;
+    }
+}
+
+static const MeshXTFECKernels kernels_neon = { "neon", neon_syndromes, neon_encode };
+
+const MeshXTFECKernels *meshxt_fec_simd_kernels(uint8_t backend) {
+    return (backend == MESHXT_FEC_BACKEND_AUTO || backend == MESHXT_FEC_BACKEND_NEON)
+               ? &kernels_neon : NULL;
+}
+
+#endif
+
+#endif // MESHXT_FEC_SIMD
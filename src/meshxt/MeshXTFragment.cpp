@@ -0,0 +1,142 @@
+#include "MeshXTFragment.h"
+#include <string.h>
+
+static size_t slice_for(size_t maxFragment) {
+    if (maxFragment <= MESHXT_FRAGMENT_HEADER) return 0;
+    size_t slice = maxFragment - MESHXT_FRAGMENT_HEADER;
+    return slice > 0xFF ? 0xFF : slice;
+}
+
+static inline uint16_t all_fragments(uint8_t count) {
+    return (uint16_t)((1u << count) - 1);
+}
+
+// ------------------------------------------------------------
+// Sender
+// ------------------------------------------------------------
+
+int meshxt_fragment_count(size_t frameLen, size_t maxFragment) {
+    size_t slice = slice_for(maxFragment);
+    if (slice == 0 || frameLen == 0) return -1;
+
+    size_t n = (frameLen + slice - 1) / slice;
+    return n <= MESHXT_FRAGMENT_MAX ? (int)n : -1;
+}
+
+int meshxt_fragment_build(const uint8_t *frame, size_t frameLen, uint8_t id, uint8_t index,
+                          size_t maxFragment, uint8_t *out) {
+    int count = meshxt_fragment_count(frameLen, maxFragment);
+    if (count < 0 || index >= count) return -1;
+
+    size_t slice = slice_for(maxFragment);
+    size_t off = (size_t)index * slice;
+    size_t len = frameLen - off < slice ? frameLen - off : slice;
+
+    out[0] = MESHXT_FRAGMENT_TAG | (frame[0] & ~MESHXT_FRAGMENT_TAG_MASK);
+    out[1] = id;
+    out[2] = (uint8_t)((index << 4) | (count - 1));
+    out[3] = (uint8_t)slice;
+    memcpy(out + MESHXT_FRAGMENT_HEADER, frame + off, len);
+    return (int)(MESHXT_FRAGMENT_HEADER + len);
+}
+
+bool meshxt_fragment_is(const uint8_t *data, size_t len) {
+    return len > MESHXT_FRAGMENT_HEADER &&
+           (data[0] & MESHXT_FRAGMENT_TAG_MASK) == MESHXT_FRAGMENT_TAG;
+}
+
+bool meshxt_fragment_is_status(const uint8_t *data, size_t len) {
+    return len == MESHXT_FRAGMENT_STATUS_SIZE &&
+           (data[0] & MESHXT_FRAGMENT_TAG_MASK) == MESHXT_FRAGMENT_STATUS_TAG;
+}
+
+int meshxt_fragment_status(uint8_t version, uint8_t id, uint16_t missing, uint8_t *out) {
+    out[0] = MESHXT_FRAGMENT_STATUS_TAG | (version & ~MESHXT_FRAGMENT_TAG_MASK);
+    out[1] = id;
+    out[2] = (uint8_t)(missing >> 8);
+    out[3] = (uint8_t)missing;
+    return MESHXT_FRAGMENT_STATUS_SIZE;
+}
+
+int meshxt_fragment_parse_status(const uint8_t *data, size_t len, uint8_t *id, uint16_t *missing) {
+    if (!meshxt_fragment_is_status(data, len)) return -1;
+    *id = data[1];
+    *missing = (uint16_t)((data[2] << 8) | data[3]);
+    return 0;
+}
+
+// ------------------------------------------------------------
+// Receiver
+// ------------------------------------------------------------
+
+int meshxt_reassembly_add(MeshXTReassembly *table, size_t count, const uint8_t *frag,
+                          size_t fragLen, uint32_t now, MeshXTReassembly **slot) {
+    if (count == 0 || !meshxt_fragment_is(frag, fragLen)) return -1;
+
+    uint8_t id     = frag[1];
+    uint8_t index  = frag[2] >> 4;
+    uint8_t total  = (uint8_t)((frag[2] & 0x0F) + 1);
+    uint8_t slice  = frag[3];
+    size_t  len    = fragLen - MESHXT_FRAGMENT_HEADER;
+    bool    last   = index == total - 1;
+
+    // Every fragment but the last is a full slice; the frame must fit
+    if (index >= total || slice == 0) return -1;
+    if (last ? len > slice : len != slice) return -1;
+    size_t off = (size_t)index * slice;
+    if (off + len > MESHXT_REASSEMBLY_MAX) return -1;
+
+    MeshXTReassembly *r = NULL;
+    MeshXTReassembly *victim = NULL;
+    for (size_t i = 0; i < count; i++) {
+        MeshXTReassembly *t = &table[i];
+        if (t->active && t->id == id) {
+            r = t;
+            break;
+        }
+        if (!t->active) {
+            if (!victim || victim->active) victim = t;
+        } else if (!victim || (victim->active && (int32_t)(t->started - victim->started) < 0)) {
+            victim = t;
+        }
+    }
+
+    if (r && (r->count != total || r->slice != slice)) r->active = false;  // Id reused
+    if (!r || !r->active) {
+        if (!r) r = victim;
+        r->active  = true;
+        r->id      = id;
+        r->count   = total;
+        r->slice   = slice;
+        r->have    = 0;
+        r->len     = 0;
+        r->started = now;
+    }
+    *slot = r;
+
+    memcpy(r->frame + off, frag + MESHXT_FRAGMENT_HEADER, len);
+    r->have |= (uint16_t)(1u << index);
+    if (last) r->len = (uint16_t)(off + len);
+
+    return r->have == all_fragments(r->count) ? 1 : 0;
+}
+
+uint16_t meshxt_reassembly_missing(const MeshXTReassembly *r) {
+    return r->active ? (uint16_t)(all_fragments(r->count) & ~r->have) : 0;
+}
+
+void meshxt_reassembly_release(MeshXTReassembly *r) {
+    r->active = false;
+}
+
+size_t meshxt_reassembly_expire(MeshXTReassembly *table, size_t count, uint32_t now,
+                                uint32_t timeout) {
+    size_t freed = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (table[i].active && now - table[i].started > timeout) {
+            table[i].active = false;
+            freed++;
+        }
+    }
+    return freed;
+}
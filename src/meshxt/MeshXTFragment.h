@@ -0,0 +1,120 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * MeshXT fragmentation of relay frames larger than one uplink
+ *
+ * At SF10-12 an EU868 uplink carries 51 bytes, less than a long message
+ * with its relay header and parity. The frame is cut into up to 16
+ * fragments sent as separate uplinks. The receiver reassembles them,
+ * and reports the ones still missing so that only those are sent again.
+ *
+ * Fragment:
+ *   Byte 0:    0x80 | relay version
+ *   Byte 1:    Message id (per sender, wraps)
+ *   Byte 2:    [IIII NNNN] Fragment index | Fragment count - 1
+ *   Byte 3:    Slice length (bytes carried by every fragment but the last)
+ *   Byte 4+:   Bytes [index * slice, index * slice + slice) of the frame
+ *
+ * Status (receiver to sender):
+ *   Byte 0:    0x40 | relay version
+ *   Byte 1:    Message id
+ *   Byte 2-3:  Missing bitmap (big-endian, bit i = fragment i); 0 = complete
+ *
+ * Byte 0's top two bits keep these apart from relay frames (00) and
+ * containers (11, MeshXTContainer.h).
+ */
+
+#define MESHXT_FRAGMENT_TAG         0x80
+#define MESHXT_FRAGMENT_STATUS_TAG  0x40
+#define MESHXT_FRAGMENT_TAG_MASK    0xC0
+#define MESHXT_FRAGMENT_HEADER      4
+#define MESHXT_FRAGMENT_STATUS_SIZE 4
+#define MESHXT_FRAGMENT_MAX         16
+
+// Largest frame a reassembly slot holds
+#ifndef MESHXT_REASSEMBLY_MAX
+#define MESHXT_REASSEMBLY_MAX       320
+#endif
+
+/**
+ * Message being reassembled.
+ */
+typedef struct {
+    bool     active;
+    uint8_t  id;
+    uint8_t  count;         // Fragments in the message
+    uint8_t  slice;
+    uint16_t have;          // Bitmap of fragments received
+    uint16_t len;           // Frame length, known once the last fragment is in
+    uint32_t started;       // Tick of the first fragment
+    uint8_t  frame[MESHXT_REASSEMBLY_MAX];
+} MeshXTReassembly;
+
+/**
+ * Number of fragments for a frame.
+ *
+ * @param frameLen     Relay frame length
+ * @param maxFragment  Largest fragment (uplink payload limit)
+ * @return             1..MESHXT_FRAGMENT_MAX, or -1 if the frame cannot
+ *                     be cut that finely
+ */
+int meshxt_fragment_count(size_t frameLen, size_t maxFragment);
+
+/**
+ * Build one fragment of a frame.
+ *
+ * @param frame        Relay frame
+ * @param frameLen     Relay frame length
+ * @param id           Message id
+ * @param index        Fragment index (< meshxt_fragment_count())
+ * @param maxFragment  Largest fragment, as passed to meshxt_fragment_count()
+ * @param out          Output (at least maxFragment bytes)
+ * @return             Fragment length, or -1 on bad arguments
+ */
+int meshxt_fragment_build(const uint8_t *frame, size_t frameLen, uint8_t id, uint8_t index,
+                          size_t maxFragment, uint8_t *out);
+
+/**
+ * Whether a payload is a fragment / a fragment status.
+ */
+bool meshxt_fragment_is(const uint8_t *data, size_t len);
+bool meshxt_fragment_is_status(const uint8_t *data, size_t len);
+
+/**
+ * Build and parse status frames.
+ */
+int meshxt_fragment_status(uint8_t version, uint8_t id, uint16_t missing, uint8_t *out);
+int meshxt_fragment_parse_status(const uint8_t *data, size_t len, uint8_t *id, uint16_t *missing);
+
+/**
+ * Add a fragment to a table of reassembly slots. A new message takes a
+ * free slot, else the oldest one. A slot whose id is reused with a
+ * different shape is restarted.
+ *
+ * @param now   Monotonic tick (e.g. millis())
+ * @param slot  Set to the message's slot (unless -1)
+ * @return      1 when the message is complete (slot->frame, slot->len;
+ *              call meshxt_reassembly_release() after use), 0 if more
+ *              fragments are needed, -1 if the fragment is malformed
+ */
+int meshxt_reassembly_add(MeshXTReassembly *table, size_t count, const uint8_t *frag,
+                          size_t fragLen, uint32_t now, MeshXTReassembly **slot);
+
+/**
+ * Bitmap of fragments not yet received (for a status frame).
+ */
+uint16_t meshxt_reassembly_missing(const MeshXTReassembly *r);
+
+void meshxt_reassembly_release(MeshXTReassembly *r);
+
+/**
+ * Drop messages whose first fragment is older than timeout.
+ *
+ * @return  Number of slots freed
+ */
+size_t meshxt_reassembly_expire(MeshXTReassembly *table, size_t count, uint32_t now,
+                                uint32_t timeout);
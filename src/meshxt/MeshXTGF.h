@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+#include "MeshXTSeq.h"
+
+/**
+ * GF(2^8) arithmetic tables for the MeshXT Reed-Solomon codec.
+ *
+ * Everything here is evaluated at compile time (C++11 constexpr), so the
+ * tables live in flash/rodata: no init call, no RAM, no startup race.
+ *
+ * Primitive polynomial: x^8 + x^4 + x^3 + x^2 + 1 (0x11D), generator alpha = 2.
+ * Generator polynomials use consecutive roots alpha^0 .. alpha^(nsym-1).
+ */
+
+#define MESHXT_GF_PRIM_POLY 0x11D
+
+struct MeshXTGFTables {
+    uint8_t exp[512];   // alpha^i, doubled so exp[log a + log b] needs no modulo
+    uint8_t log[256];   // log[0] is unused
+};
+
+/**
+ * Generator polynomials in log form, laid out in LFSR order:
+ * genLog[j] = log(g_(nsym-1-j)). The monic x^nsym term is implicit.
+ */
+struct MeshXTGFGenerators {
+    uint8_t low[16];
+    uint8_t medium[32];
+    uint8_t high[64];
+};
+
+extern const MeshXTGFTables     meshxt_gf;
+extern const MeshXTGFGenerators meshxt_gf_gen;
+
+// ------------------------------------------------------------
+// Compile-time construction
+// ------------------------------------------------------------
+
+constexpr uint8_t meshxt_gf_xtime(unsigned x) {
+    return (uint8_t)((x & 0x80) ? ((x << 1) ^ MESHXT_GF_PRIM_POLY) : (x << 1));
+}
+
+constexpr uint8_t meshxt_gf_exp_at(int i) {
+    return i == 0 ? 1 : meshxt_gf_xtime(meshxt_gf_exp_at(i - 1));
+}
+
+constexpr uint8_t meshxt_gf_log_find(unsigned x, int i, unsigned v) {
+    return v == x ? (uint8_t)i : meshxt_gf_log_find(x, i + 1, meshxt_gf_xtime(v));
+}
+
+constexpr uint8_t meshxt_gf_log_at(int x) {
+    return x == 0 ? 0 : meshxt_gf_log_find((unsigned)x, 0, 1);
+}
+
+// Shift-and-add multiply; only used while building tables
+constexpr uint8_t meshxt_gf_mul_slow(unsigned a, unsigned b) {
+    return (a == 0 || b == 0) ? 0
+         : (uint8_t)(((b & 1) ? a : 0) ^ meshxt_gf_mul_slow(meshxt_gf_xtime(a), b >> 1));
+}
+
+template<int... E, int... L>
+constexpr MeshXTGFTables meshxt_gf_build_tables(MeshXTSeq<E...>, MeshXTSeq<L...>) {
+    return MeshXTGFTables{ { meshxt_gf_exp_at(E % 255)... }, { meshxt_gf_log_at(L)... } };
+}
+
+struct MeshXTGFPoly {
+    uint8_t c[65];      // c[j] is the coefficient of x^j
+};
+
+// p(x) * (x + root)
+template<int... J>
+constexpr MeshXTGFPoly meshxt_gf_poly_step(MeshXTGFPoly p, uint8_t root, MeshXTSeq<J...>) {
+    return MeshXTGFPoly{ { (uint8_t)((J > 0 ? p.c[J > 0 ? J - 1 : 0] : 0) ^
+                                     meshxt_gf_mul_slow(p.c[J], root))... } };
+}
+
+constexpr MeshXTGFPoly meshxt_gf_generator(int nsym) {
+    return nsym == 0
+        ? MeshXTGFPoly{ { 1 } }
+        : meshxt_gf_poly_step(meshxt_gf_generator(nsym - 1), meshxt_gf_exp_at(nsym - 1),
+                              MeshXTMakeSeq<65>::type());
+}
+
+// Log form needs every coefficient nonzero; true for 16/32/64 with 0x11D
+constexpr bool meshxt_gf_poly_nonzero(MeshXTGFPoly p, int deg) {
+    return deg < 0 ? true : (p.c[deg] != 0 && meshxt_gf_poly_nonzero(p, deg - 1));
+}
+
+template<int... A, int... B, int... C>
+constexpr MeshXTGFGenerators meshxt_gf_build_generators(MeshXTGFPoly g16, MeshXTGFPoly g32, MeshXTGFPoly g64,
+                                                        MeshXTSeq<A...>, MeshXTSeq<B...>,
+                                                        MeshXTSeq<C...>) {
+    return MeshXTGFGenerators{
+        { meshxt_gf_log_at(g16.c[15 - A])... },
+        { meshxt_gf_log_at(g32.c[31 - B])... },
+        { meshxt_gf_log_at(g64.c[63 - C])... } };
+}
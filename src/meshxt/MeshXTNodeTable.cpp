@@ -0,0 +1,60 @@
+#include "MeshXTNodeTable.h"
+#include <string.h>
+
+void meshxt_node_reset(MeshXTNodeSlot *table, size_t count, uint32_t seed) {
+    memset(table, 0, count * sizeof(*table));
+    uint32_t bits = seed;
+    for (size_t i = 0; i < count; i++) {
+        if (i % 16 == 0 && i > 0) bits = bits * 0x9E3779B1u + 1;
+        table[i].gen = (uint8_t)((bits >> (2 * (i % 16))) & MESHXT_NODE_GEN_MASK);
+    }
+}
+
+int meshxt_node_index(MeshXTNodeSlot *table, size_t count, uint32_t node, uint32_t now,
+                      uint16_t announce, uint16_t reannounce, bool *withId, uint8_t *gen) {
+    if (count == 0 || node == 0) return -1;
+
+    size_t slot = count;
+    for (size_t i = 0; i < count; i++) {
+        if (table[i].node == node) {
+            slot = i;
+            break;
+        }
+    }
+
+    if (slot == count) {
+        // Free slot, else the least recently used
+        slot = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (table[i].node == 0) {
+                slot = i;
+                break;
+            }
+            if ((int32_t)(table[i].lastUsed - table[slot].lastUsed) < 0) slot = i;
+        }
+        table[slot].node = node;
+        table[slot].sent = 0;
+        table[slot].gen  = (uint8_t)((table[slot].gen + 1) & MESHXT_NODE_GEN_MASK);
+    }
+
+    MeshXTNodeSlot *s = &table[slot];
+    *withId = s->sent < announce ||
+              (reannounce && (s->sent - announce) % reannounce == reannounce - 1);
+    s->lastUsed = now;
+    s->sent = s->sent == 0xFFFF ? announce : (uint16_t)(s->sent + 1);
+    *gen = s->gen;
+    return (int)slot;
+}
+
+void meshxt_node_bind(MeshXTNodeSlot *table, size_t count, uint16_t index, uint32_t node,
+                      uint8_t gen) {
+    if (index >= count) return;
+    table[index].node = node;
+    table[index].gen  = gen;
+}
+
+uint32_t meshxt_node_resolve(const MeshXTNodeSlot *table, size_t count, uint16_t index,
+                             uint8_t gen) {
+    if (index >= count || table[index].gen != gen) return 0;
+    return table[index].node;
+}
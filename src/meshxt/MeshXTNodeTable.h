@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * MeshXT node table: short indices for 32-bit Meshtastic node IDs
+ *
+ * The v2 relay header names the sender by a small index into a table
+ * kept per link. The sender binds nodes to indices (least recently used
+ * slot first) and puts the full ID in the frames right after a binding
+ * and then every so often. The receiver learns the bindings from those
+ * frames and resolves the index in every other frame.
+ *
+ * Indices are only meaningful per sender: the ground keeps one table per
+ * gateway.
+ *
+ * Frames leave in priority and retry order and some are lost, so the
+ * receiver can hold a stale binding: the announcements of a rebound slot
+ * were lost, or overtook older frames of the slot's previous node, or the
+ * sender restarted. Each binding therefore has a 2-bit generation, sent
+ * in every frame. It is bumped on every rebind and starts from a per-boot
+ * seed. A frame whose generation differs from the receiver's binding is
+ * dropped instead of being credited to the wrong node.
+ */
+
+#define MESHXT_NODE_GEN_MASK  0x03
+
+typedef struct {
+    uint32_t node;          // 0 = free
+    uint32_t lastUsed;      // Sender: eviction tick
+    uint16_t sent;          // Sender: frames sent since the binding
+    uint8_t  gen;           // Binding generation (MESHXT_NODE_GEN_MASK bits)
+} MeshXTNodeSlot;
+
+/**
+ * Sender: clear the table and start each slot's generation from seed.
+ * The seed should differ from one boot to the next, so that bindings
+ * made after a restart do not match the receiver's old ones.
+ */
+void meshxt_node_reset(MeshXTNodeSlot *table, size_t count, uint32_t seed);
+
+/**
+ * Sender: index for a node, binding the least recently used slot if the
+ * node has none.
+ *
+ * @param now          Monotonic tick (e.g. millis())
+ * @param announce     First frames after a binding that carry the full ID
+ * @param reannounce   Then every Nth frame carries it (0 = never)
+ * @param withId       Set if this frame must carry the full ID
+ * @param gen          Set to the binding's generation
+ * @return             Slot index, or -1 if count is 0 or node is 0
+ */
+int meshxt_node_index(MeshXTNodeSlot *table, size_t count, uint32_t node, uint32_t now,
+                      uint16_t announce, uint16_t reannounce, bool *withId, uint8_t *gen);
+
+/**
+ * Receiver: record a binding seen in a frame that carried the full ID.
+ */
+void meshxt_node_bind(MeshXTNodeSlot *table, size_t count, uint16_t index, uint32_t node,
+                      uint8_t gen);
+
+/**
+ * Receiver: node ID for an index, or 0 if no binding has been seen or
+ * the binding is of another generation.
+ */
+uint32_t meshxt_node_resolve(const MeshXTNodeSlot *table, size_t count, uint16_t index,
+                             uint8_t gen);
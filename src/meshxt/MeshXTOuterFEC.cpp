@@ -0,0 +1,115 @@
+#include "MeshXTOuterFEC.h"
+#include "MeshXTFEC.h"
+#include "MeshXTGF.h"
+#include <string.h>
+
+static inline uint8_t gf_mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) return 0;
+    return meshxt_gf.exp[meshxt_gf.log[a] + meshxt_gf.log[b]];
+}
+
+int meshxt_outer_begin(MeshXTOuterEncoder *enc, uint8_t group, uint8_t k, uint8_t m) {
+    if (k == 0 || k > MESHXT_OUTER_MAX_DATA || m > MESHXT_OUTER_MAX_PARITY) return -1;
+
+    enc->group = group & 0x0F;
+    enc->k     = k;
+    enc->m     = m;
+    enc->count = 0;
+    enc->width = 0;
+
+    // g(x) = (x + a^0)(x + a^1)...(x + a^(m-1)), the inner code's generator
+    // for nsym = m, so columns decode with meshxt_fec_decode_erasures
+    uint8_t g[MESHXT_OUTER_MAX_PARITY + 1];
+    memset(g, 0, sizeof(g));
+    g[0] = 1;
+    for (int i = 0; i < m; i++) {
+        uint8_t root = meshxt_gf.exp[i];
+        for (int j = i + 1; j > 0; j--) {
+            g[j] = g[j - 1] ^ gf_mul(g[j], root);
+        }
+        g[0] = gf_mul(g[0], root);
+    }
+    for (int j = 0; j < m; j++) {
+        enc->gen[j] = g[m - 1 - j];
+    }
+    return 0;
+}
+
+int meshxt_outer_data_frame(const MeshXTOuterEncoder *enc, const uint8_t *payload, uint8_t len,
+                            uint8_t *out) {
+    if (enc->count >= enc->k || len > MESHXT_OUTER_MAX_PAYLOAD) return -1;
+
+    out[0] = (uint8_t)((enc->group << 4) | enc->count);
+    memcpy(out + MESHXT_OUTER_DATA_HEADER, payload, len);
+    return MESHXT_OUTER_DATA_HEADER + len;
+}
+
+int meshxt_outer_add(MeshXTOuterEncoder *enc, const uint8_t *payload, uint8_t len) {
+    if (enc->count >= enc->k || len > MESHXT_OUTER_MAX_PAYLOAD) return -1;
+
+    uint8_t rowLen = (uint8_t)(len + 1);
+    uint8_t width  = rowLen > enc->width ? rowLen : enc->width;
+    uint8_t m      = enc->m;
+
+    // One LFSR step per column. Columns past the widest row so far have
+    // only seen zeros, so their registers are still zero and stay zero.
+    if (m > 0) {
+        if (rowLen > enc->width) {
+            memset(enc->reg[enc->width], 0, (size_t)(rowLen - enc->width) * MESHXT_OUTER_MAX_PARITY);
+        }
+        for (int c = 0; c < width; c++) {
+            uint8_t in = c == 0 ? len : (c < rowLen ? payload[c - 1] : 0);
+            uint8_t *reg = enc->reg[c];
+            uint8_t feedback = in ^ reg[0];
+            for (int j = 0; j < m - 1; j++) {
+                reg[j] = reg[j + 1] ^ gf_mul(enc->gen[j], feedback);
+            }
+            reg[m - 1] = gf_mul(enc->gen[m - 1], feedback);
+        }
+    }
+
+    enc->width = width;
+    return enc->count++;
+}
+
+bool meshxt_outer_full(const MeshXTOuterEncoder *enc) {
+    return enc->count >= enc->k;
+}
+
+int meshxt_outer_parity_frame(const MeshXTOuterEncoder *enc, uint8_t j, uint8_t *out) {
+    if (enc->count == 0 || j >= enc->m) return -1;
+
+    out[0] = (uint8_t)((enc->group << 4) | j);
+    out[1] = (uint8_t)(((enc->count - 1) << 4) | (enc->m - 1));
+    for (int c = 0; c < enc->width; c++) {
+        out[MESHXT_OUTER_PARITY_HEADER + c] = enc->reg[c][j];
+    }
+    return MESHXT_OUTER_PARITY_HEADER + enc->width;
+}
+
+int meshxt_outer_recover(uint8_t *const *rows, uint8_t count, uint8_t m, uint8_t width,
+                         const uint8_t *lost, uint8_t numLost) {
+    if (count == 0 || count > MESHXT_OUTER_MAX_DATA || m == 0 || m > MESHXT_OUTER_MAX_DATA) return -1;
+    if (numLost > m) return -1;
+
+    uint8_t n = (uint8_t)(count + m);
+    int rebuilt = 0;
+    for (int i = 0; i < numLost; i++) {
+        if (lost[i] >= n) return -1;
+        if (lost[i] < count) rebuilt++;
+    }
+    if (rebuilt == 0) return 0;
+
+    uint8_t cw[2 * MESHXT_OUTER_MAX_DATA];
+    for (int c = 0; c < width; c++) {
+        for (int i = 0; i < n; i++) cw[i] = rows[i][c];
+        for (int i = 0; i < numLost; i++) cw[lost[i]] = 0;
+
+        if (meshxt_fec_decode_erasures(cw, n, cw, m, lost, numLost, NULL) < 0) return -1;
+
+        for (int i = 0; i < numLost; i++) {
+            if (lost[i] < count) rows[lost[i]][c] = cw[lost[i]];
+        }
+    }
+    return rebuilt;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * MeshXT outer code: erasure parity across uplink frames
+ *
+ * The inner Reed-Solomon code (MeshXTFEC) repairs bytes inside a frame,
+ * but the usual satellite failure is a whole frame that never arrives.
+ * The outer code groups up to K data frames and sends M parity frames
+ * after them. Byte column c of every frame in a group forms one RS
+ * codeword (K data symbols + M parity symbols, same field and generator
+ * as the inner code). The ground decoder knows which frames are missing,
+ * so up to M lost frames of a group are rebuilt as erasures.
+ *
+ * Row layout (the bytes fed into the columns for one data frame):
+ *   Byte 0:    Payload length
+ *   Byte 1+:   Payload, zero-padded to the group width
+ *
+ * Data frame (LORAWAN_FPORT_OUTER_DATA):
+ *   Byte 0:    [GGGG RRRR] Group (4 bits) | Row index (4 bits)
+ *   Byte 1+:   Payload
+ *
+ * Parity frame (LORAWAN_FPORT_OUTER_PARITY):
+ *   Byte 0:    [GGGG PPPP] Group (4 bits) | Parity index (4 bits)
+ *   Byte 1:    [KKKK MMMM] Data rows - 1 (4 bits) | Parity rows - 1 (4 bits)
+ *   Byte 2+:   Parity row (group width bytes)
+ *
+ * A short group (flushed before K frames were sent) is a shortened code,
+ * so the K field in the parity header always gives the real row count.
+ */
+
+#define MESHXT_OUTER_MAX_DATA        16    // K limit (4-bit field)
+#define MESHXT_OUTER_DATA_HEADER     1
+#define MESHXT_OUTER_PARITY_HEADER   2
+
+// Parity rows kept per encoder; RAM is MAX_PARITY * MAX_ROW bytes
+#ifndef MESHXT_OUTER_MAX_PARITY
+#define MESHXT_OUTER_MAX_PARITY      4
+#endif
+
+// Widest row (length byte + payload) that still fits a parity frame
+#ifndef MESHXT_OUTER_MAX_ROW
+#define MESHXT_OUTER_MAX_ROW         126
+#endif
+
+#define MESHXT_OUTER_MAX_PAYLOAD     (MESHXT_OUTER_MAX_ROW - 1)
+
+/**
+ * Encoder state for one group. Parity is accumulated as each data frame
+ * is sent, so the frames themselves never need to be kept.
+ */
+typedef struct {
+    uint8_t group;                                          // 4-bit group id
+    uint8_t k;                                              // Data rows per full group
+    uint8_t m;                                              // Parity rows (0 = disabled)
+    uint8_t count;                                          // Data rows added so far
+    uint8_t width;                                          // Widest row so far
+    uint8_t gen[MESHXT_OUTER_MAX_PARITY];                   // Generator, LFSR order
+    uint8_t reg[MESHXT_OUTER_MAX_ROW][MESHXT_OUTER_MAX_PARITY];  // Per-column LFSR
+} MeshXTOuterEncoder;
+
+/**
+ * Start a new group.
+ *
+ * @param enc    Encoder state
+ * @param group  Group id (low 4 bits used)
+ * @param k      Data frames per group (1..16)
+ * @param m      Parity frames per group (0..MESHXT_OUTER_MAX_PARITY, 0 disables)
+ * @return       0 on success, -1 on invalid parameters
+ */
+int meshxt_outer_begin(MeshXTOuterEncoder *enc, uint8_t group, uint8_t k, uint8_t m);
+
+/**
+ * Wrap a payload as the next data frame of the group (tag byte + payload).
+ * Does not add it to the parity; call meshxt_outer_add once it is sent.
+ *
+ * @return  Frame length, or -1 if the group is full or the payload too long
+ */
+int meshxt_outer_data_frame(const MeshXTOuterEncoder *enc, const uint8_t *payload, uint8_t len,
+                            uint8_t *out);
+
+/**
+ * Fold a transmitted payload into the group parity as the next row.
+ *
+ * @return  Row index, or -1 if the group is full or the payload too long
+ */
+int meshxt_outer_add(MeshXTOuterEncoder *enc, const uint8_t *payload, uint8_t len);
+
+/**
+ * True once K rows have been added and the parity frames are due.
+ */
+bool meshxt_outer_full(const MeshXTOuterEncoder *enc);
+
+/**
+ * Build parity frame j (0 .. m-1) for the rows added so far.
+ *
+ * @param out  Output buffer, at least MESHXT_OUTER_PARITY_HEADER + MESHXT_OUTER_MAX_ROW bytes
+ * @return     Frame length, or -1 if the group is empty or j is out of range
+ */
+int meshxt_outer_parity_frame(const MeshXTOuterEncoder *enc, uint8_t j, uint8_t *out);
+
+/**
+ * Ground side: rebuild lost data rows of one group in place.
+ *
+ * rows[0 .. count-1] are the data rows and rows[count .. count+m-1] the
+ * parity rows, each width bytes (data rows in row layout, zero-padded).
+ * Contents of the lost rows are ignored and data rows are overwritten
+ * with the recovered bytes; the payload is then row[1 .. row[0]].
+ *
+ * @param rows     count + m row pointers
+ * @param count    Data rows in the group (K field of the parity header)
+ * @param m        Parity rows in the group
+ * @param width    Row width (parity frame length - MESHXT_OUTER_PARITY_HEADER)
+ * @param lost     Indices into rows of the frames that never arrived
+ * @param numLost  Number of lost rows (at most m)
+ * @return         Number of data rows rebuilt, or -1 if unrecoverable
+ */
+int meshxt_outer_recover(uint8_t *const *rows, uint8_t count, uint8_t m, uint8_t width,
+                         const uint8_t *lost, uint8_t numLost);
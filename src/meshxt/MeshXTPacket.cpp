@@ -1,5 +1,6 @@
 #include "MeshXTPacket.h"
-#include "MeshXTCompress.h"
+#include "MeshXTCodebook.h"
+#include "MeshXTEntropy.h"
 #include "MeshXTFEC.h"
 #include <string.h>
 
@@ -25,112 +26,128 @@ static void decode_header(const uint8_t *buf, MeshXTHeader *hdr) {
 }
 
 int meshxt_create_packet(const char *message, uint8_t *output, uint8_t compType, uint8_t fecCode) {
-    uint8_t payload[256];
+    uint8_t *payload = output + MESHXT_HEADER_SIZE;
+    size_t payloadCap = MESHXT_MAX_PACKET_SIZE - MESHXT_HEADER_SIZE - meshxt_fec_nsym_from_code(fecCode);
+    size_t messageLen = strlen(message);
     int payloadLen;
 
-    // Step 1: Compress
+    // Step 1: Compress straight into the packet, leaving room for parity
     switch (compType) {
         case MESHXT_COMP_SMAZ:
-            payloadLen = meshxt_compress(message, payload, sizeof(payload));
-            if (payloadLen < 0) return -1;
+        case MESHXT_COMP_CODEBOOK:
+            payloadLen = meshxt_compress_bytes((const uint8_t *)message, messageLen,
+                                               payload, payloadCap);
+            break;
+        case MESHXT_COMP_ENTROPY:
+            payloadLen = meshxt_entropy_encode((const uint8_t *)message, messageLen,
+                                               payload, payloadCap);
             break;
         case MESHXT_COMP_NONE:
-            payloadLen = (int)strlen(message);
-            if (payloadLen > 237) return -1;
-            memcpy(payload, message, payloadLen);
+            if (messageLen > payloadCap) return -1;
+            memcpy(payload, message, messageLen);
+            payloadLen = (int)messageLen;
             break;
         default:
             return -1;
     }
+    if (payloadLen < 0) return -1;
 
-    // Step 2: Apply FEC
-    uint8_t nsym = meshxt_fec_nsym_from_code(fecCode);
-    uint8_t fecData[320]; // payload + parity
-    int fecLen;
-
-    if (nsym > 0) {
-        fecLen = meshxt_fec_encode(payload, payloadLen, fecData, nsym);
-        if (fecLen < 0) return -1;
-    } else {
-        memcpy(fecData, payload, payloadLen);
-        fecLen = payloadLen;
-    }
-
-    // Step 3: Build header
-    encode_header(output, MESHXT_PACKET_VERSION, compType, fecCode, 0);
+    // Step 2: Header and parity
+    return meshxt_finish_packet(output, payloadLen, compType, fecCode);
+}
 
-    // Step 4: Assemble
-    int totalLen = MESHXT_HEADER_SIZE + fecLen;
+int meshxt_finish_packet(uint8_t *packet, size_t payloadLen, uint8_t compType, uint8_t fecCode) {
+    uint8_t nsym = meshxt_fec_nsym_from_code(fecCode);
+    size_t totalLen = MESHXT_HEADER_SIZE + payloadLen + nsym;
     if (totalLen > MESHXT_MAX_PACKET_SIZE) return -1;
 
-    memcpy(output + MESHXT_HEADER_SIZE, fecData, fecLen);
+    // Parity is appended right after the payload
+    uint8_t *payload = packet + MESHXT_HEADER_SIZE;
+    if (nsym > 0 && meshxt_fec_encode(payload, payloadLen, payload, nsym) < 0) return -1;
 
-    return totalLen;
+    encode_header(packet, MESHXT_PACKET_VERSION, compType, fecCode, 0);
+    return (int)totalLen;
 }
 
-int meshxt_parse_packet(const uint8_t *packet, size_t packetLen, MeshXTParseResult *result) {
-    memset(result, 0, sizeof(MeshXTParseResult));
+int meshxt_parse_packet_view(uint8_t *packet, size_t packetLen, uint8_t *out, size_t outCap,
+                             MeshXTPacketView *view) {
+    memset(view, 0, sizeof(MeshXTPacketView));
 
-    if (packetLen < MESHXT_HEADER_SIZE) {
-        result->valid = false;
-        return -1;
-    }
+    if (packetLen < MESHXT_HEADER_SIZE) return -1;
 
     // Step 1: Parse header
-    decode_header(packet, &result->header);
-
-    if (result->header.version != MESHXT_PACKET_VERSION) {
-        result->valid = false;
-        return -1;
-    }
+    decode_header(packet, &view->header);
+    if (view->header.version != MESHXT_PACKET_VERSION) return -1;
 
-    // Step 2: Extract data after header
-    const uint8_t *data = packet + MESHXT_HEADER_SIZE;
+    // Step 2: FEC decode in place; the payload stays where it is
+    uint8_t *data = packet + MESHXT_HEADER_SIZE;
     size_t dataLen = packetLen - MESHXT_HEADER_SIZE;
-
-    // Step 3: FEC decode
-    uint8_t nsym = meshxt_fec_nsym_from_code(result->header.fecLevel);
-    uint8_t decoded[256];
-    int decodedLen;
+    uint8_t nsym = meshxt_fec_nsym_from_code(view->header.fecLevel);
+    int payloadLen;
 
     if (nsym > 0) {
-        decodedLen = meshxt_fec_decode(data, dataLen, decoded, nsym);
-        if (decodedLen < 0) {
-            result->valid = false;
-            return -1;
-        }
+        uint8_t corrected = 0;
+        payloadLen = meshxt_fec_decode_erasures(data, dataLen, data, nsym, NULL, 0, &corrected);
+        if (payloadLen < 0) return -1;
+        view->fecCorrected = corrected;
     } else {
-        decodedLen = (int)dataLen;
-        memcpy(decoded, data, dataLen);
+        payloadLen = (int)dataLen;
     }
+    view->payloadSize = payloadLen;
 
-    result->payloadSize = decodedLen;
-
-    // Step 4: Decompress
-    switch (result->header.compType) {
+    // Step 3: Decompress into out, or point at the payload if it is plain
+    switch (view->header.compType) {
         case MESHXT_COMP_SMAZ:
-            result->messageLen = meshxt_decompress(decoded, decodedLen,
-                                                    result->message, sizeof(result->message));
-            if (result->messageLen < 0) {
-                result->valid = false;
-                return -1;
-            }
+        case MESHXT_COMP_CODEBOOK:
+            if (!out) return -1;
+            view->messageLen = meshxt_decompress_bytes(data, payloadLen, out, outCap);
+            view->message = out;
+            break;
+        case MESHXT_COMP_ENTROPY:
+            if (!out) return -1;
+            view->messageLen = meshxt_entropy_decode(data, payloadLen, out, outCap);
+            view->message = out;
             break;
         case MESHXT_COMP_NONE:
-            if (decodedLen >= (int)sizeof(result->message)) {
-                result->valid = false;
-                return -1;
-            }
-            memcpy(result->message, decoded, decodedLen);
-            result->message[decodedLen] = '\0';
-            result->messageLen = decodedLen;
+            view->messageLen = payloadLen;
+            view->message = data;
             break;
         default:
-            result->valid = false;
             return -1;
     }
+    if (view->messageLen < 0) {
+        view->message = NULL;
+        return -1;
+    }
 
-    result->packetSize = (int)packetLen;
+    view->packetSize = (int)packetLen;
+    view->valid = true;
+    return 0;
+}
+
+int meshxt_parse_packet(const uint8_t *packet, size_t packetLen, MeshXTParseResult *result) {
+    memset(result, 0, sizeof(MeshXTParseResult));
+
+    // FEC corrects in place, so work on a copy of the caller's packet
+    uint8_t frame[MESHXT_MAX_PACKET_SIZE];
+    if (packetLen > sizeof(frame)) return -1;
+    memcpy(frame, packet, packetLen);
+
+    // Keep one byte for the terminator
+    MeshXTPacketView view;
+    int rc = meshxt_parse_packet_view(frame, packetLen, (uint8_t *)result->message,
+                                      sizeof(result->message) - 1, &view);
+    result->header       = view.header;
+    result->fecCorrected = view.fecCorrected;
+    result->payloadSize  = view.payloadSize;
+    if (rc < 0) return -1;
+
+    if (view.message != (const uint8_t *)result->message) {
+        memcpy(result->message, view.message, view.messageLen);
+    }
+    result->message[view.messageLen] = '\0';
+    result->messageLen = view.messageLen;
+    result->packetSize = view.packetSize;
     result->valid = true;
     return 0;
 }
@@ -10,7 +10,9 @@
  *   Byte 0: [VVVV CCCC] Version (4 bits) | Compression type (4 bits)
  *   Byte 1: [FFFF xxxx] FEC level (4 bits) | Flags (4 bits)
  *
- * Compression types: 0=none, 1=smaz, 2=codebook
+ * Compression types: 0=none, 1=smaz, 2=codebook, 3=entropy
+ *   smaz and codebook both use the 254-entry codebook in MeshXTCodebook.h
+ *   entropy is the static Huffman coder in MeshXTEntropy.h
  * FEC levels: 0=none, 1=low(16), 2=medium(32), 3=high(64)
  */
 
@@ -21,6 +23,7 @@
 #define MESHXT_COMP_NONE     0
 #define MESHXT_COMP_SMAZ     1
 #define MESHXT_COMP_CODEBOOK 2
+#define MESHXT_COMP_ENTROPY  3
 
 #define MESHXT_FEC_NONE_CODE   0
 #define MESHXT_FEC_LOW_CODE    1
@@ -38,7 +41,7 @@ typedef struct {
 } MeshXTHeader;
 
 /**
- * Result of parsing a packet.
+ * Result of parsing a packet (copying form, see meshxt_parse_packet).
  */
 typedef struct {
     char message[256];     // Decoded message text
@@ -46,12 +49,32 @@ typedef struct {
     MeshXTHeader header;   // Parsed header
     int packetSize;        // Total packet size
     int payloadSize;       // Compressed payload size
+    int fecCorrected;      // Symbols repaired by FEC (link margin indicator)
     bool valid;            // Whether parsing succeeded
 } MeshXTParseResult;
 
+/**
+ * Result of parsing a packet in place (see meshxt_parse_packet_view).
+ * message points into the packet (uncompressed payload) or into the
+ * caller's output buffer; it is not null-terminated and is valid only
+ * while those buffers are.
+ */
+typedef struct {
+    const uint8_t *message; // Decoded message bytes
+    int messageLen;        // Length of decoded message
+    MeshXTHeader header;   // Parsed header
+    int packetSize;        // Total packet size
+    int payloadSize;       // Compressed payload size
+    int fecCorrected;      // Symbols repaired by FEC (link margin indicator)
+    bool valid;            // Whether parsing succeeded
+} MeshXTPacketView;
+
 /**
  * Create a MeshXT packet from a text message.
  *
+ * Compresses straight into output after the header and appends the
+ * parity in place; no intermediate buffers.
+ *
  * @param message    Input text (null-terminated)
  * @param output     Output buffer (at least MESHXT_MAX_PACKET_SIZE bytes)
  * @param compType   Compression type (MESHXT_COMP_*)
@@ -60,9 +83,42 @@ typedef struct {
  */
 int meshxt_create_packet(const char *message, uint8_t *output, uint8_t compType, uint8_t fecCode);
 
+/**
+ * Finish a packet whose payload is already in place: write the header
+ * and append RS parity after the payload.
+ *
+ * @param packet      Buffer with the payload at packet + MESHXT_HEADER_SIZE
+ *                    (at least MESHXT_MAX_PACKET_SIZE bytes)
+ * @param payloadLen  Payload length
+ * @param compType    Compression type the payload was coded with
+ * @param fecCode     FEC level code (MESHXT_FEC_*_CODE)
+ * @return            Packet size in bytes, or -1 if it exceeds MESHXT_MAX_PACKET_SIZE
+ */
+int meshxt_finish_packet(uint8_t *packet, size_t payloadLen, uint8_t compType, uint8_t fecCode);
+
+/**
+ * Parse a MeshXT packet without copying it.
+ *
+ * FEC correction is done in place in packet. An uncompressed message is
+ * returned pointing into packet; a compressed one is decoded into out.
+ *
+ * @param packet     Packet bytes (modified by FEC correction)
+ * @param packetLen  Length of packet
+ * @param out        Buffer for decompressed text (may be NULL if only
+ *                   uncompressed packets are expected)
+ * @param outCap     Capacity of out in bytes
+ * @param view       Output parse result
+ * @return           0 on success, -1 on error
+ */
+int meshxt_parse_packet_view(uint8_t *packet, size_t packetLen, uint8_t *out, size_t outCap,
+                             MeshXTPacketView *view);
+
 /**
  * Parse a MeshXT packet back to a text message.
  *
+ * Copying convenience over meshxt_parse_packet_view: the packet is left
+ * untouched and the message is null-terminated in result->message.
+ *
  * @param packet     Input packet bytes
  * @param packetLen  Length of packet
  * @param result     Output parse result
@@ -0,0 +1,259 @@
+#include "MeshXTPosition.h"
+#include <string.h>
+
+// ------------------------------------------------------------
+// Varint helpers (protobuf encoding)
+// ------------------------------------------------------------
+
+static bool put_varint(uint8_t *out, size_t &o, size_t cap, uint32_t v) {
+    do {
+        if (o >= cap) return false;
+        uint8_t b = v & 0x7F;
+        v >>= 7;
+        out[o++] = v ? (uint8_t)(b | 0x80) : b;
+    } while (v);
+    return true;
+}
+
+static bool get_varint(const uint8_t *in, size_t &i, size_t len, uint64_t &v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (i >= len) return false;
+        uint8_t b = in[i++];
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool get_varint32(const uint8_t *in, size_t &i, size_t len, uint32_t &v) {
+    uint64_t wide;
+    if (!get_varint(in, i, len, wide) || wide > 0xFFFFFFFFu) return false;
+    v = (uint32_t)wide;
+    return true;
+}
+
+static inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// Nearest multiple of step, as a step count
+static inline int32_t quantize(int32_t v, uint16_t step) {
+    int64_t x = (int64_t)v + step / 2;
+    return (int32_t)(x >= 0 ? x / step : -((-x + step - 1) / step));
+}
+
+static inline uint32_t fixed32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// ------------------------------------------------------------
+// Protobuf
+// ------------------------------------------------------------
+
+int meshxt_position_parse(const uint8_t *pb, size_t len, MeshXTPosition *pos) {
+    memset(pos, 0, sizeof(*pos));
+    bool haveLat = false, haveLon = false;
+
+    size_t i = 0;
+    while (i < len) {
+        uint64_t key;
+        if (!get_varint(pb, i, len, key)) return -1;
+        uint32_t field = (uint32_t)(key >> 3);
+        uint8_t  wire  = key & 0x07;
+
+        switch (wire) {
+            case 0: {   // Varint
+                uint64_t v;
+                if (!get_varint(pb, i, len, v)) return -1;
+                if (field == 3) {               // int32 altitude (negative = 10-byte varint)
+                    pos->altitude = (int32_t)(uint32_t)v;
+                    pos->hasAltitude = true;
+                }
+                break;
+            }
+            case 1:     // 64-bit
+                if (len - i < 8) return -1;
+                i += 8;
+                break;
+            case 2: {   // Length-delimited
+                uint64_t n;
+                if (!get_varint(pb, i, len, n) || n > len - i) return -1;
+                i += (size_t)n;
+                break;
+            }
+            case 5: {   // 32-bit
+                if (len - i < 4) return -1;
+                uint32_t v = fixed32_le(pb + i);
+                i += 4;
+                if (field == 1) {               // sfixed32 latitude_i
+                    pos->latitudeI = (int32_t)v;
+                    haveLat = true;
+                } else if (field == 2) {        // sfixed32 longitude_i
+                    pos->longitudeI = (int32_t)v;
+                    haveLon = true;
+                } else if (field == 4) {        // fixed32 time
+                    pos->time = v;
+                    pos->hasTime = v != 0;
+                }
+                break;
+            }
+            default:
+                return -1;
+        }
+    }
+
+    return (haveLat && haveLon) ? 0 : -1;
+}
+
+// ------------------------------------------------------------
+// Track table
+// ------------------------------------------------------------
+
+MeshXTPositionTrack *meshxt_position_track(MeshXTPositionTrack *table, size_t count,
+                                           uint32_t node, uint32_t now) {
+    if (count == 0) return NULL;
+    if (now == 0) now = 1;  // lastUsed == 0 marks a free slot
+
+    MeshXTPositionTrack *slot = NULL;
+    for (size_t i = 0; i < count; i++) {
+        MeshXTPositionTrack *t = &table[i];
+        if (t->lastUsed && t->node == node) {
+            t->lastUsed = now;
+            return t;
+        }
+        if (!t->lastUsed) {
+            if (!slot || slot->lastUsed) slot = t;
+        } else if (!slot || (slot->lastUsed && (int32_t)(t->lastUsed - slot->lastUsed) < 0)) {
+            slot = t;
+        }
+    }
+
+    memset(slot, 0, sizeof(*slot));
+    slot->node = node;
+    slot->lastUsed = now;
+    return slot;
+}
+
+// ------------------------------------------------------------
+// Codec
+// ------------------------------------------------------------
+
+int meshxt_position_encode(MeshXTPositionTrack *track, const MeshXTPosition *pos,
+                           const MeshXTPositionQuant *quant, uint8_t keyframeEvery,
+                           uint8_t *out, size_t outCap) {
+    if (quant->latLonStep == 0 || quant->altStep == 0 || quant->timeStep == 0) return -1;
+
+    uint8_t present = (pos->hasAltitude ? MESHXT_POSITION_HAS_ALT : 0) |
+                      (pos->hasTime ? MESHXT_POSITION_HAS_TIME : 0);
+    int32_t  lat  = quantize(pos->latitudeI, quant->latLonStep);
+    int32_t  lon  = quantize(pos->longitudeI, quant->latLonStep);
+    int32_t  alt  = pos->hasAltitude ? quantize(pos->altitude, quant->altStep) : 0;
+    uint32_t time = pos->hasTime ?
+                    (uint32_t)(((uint64_t)pos->time + quant->timeStep / 2) / quant->timeStep) : 0;
+
+    bool key = !track->valid || track->sinceKey >= keyframeEvery ||
+               track->flags != present ||
+               memcmp(&track->quant, quant, sizeof(*quant)) != 0;
+
+    uint16_t seq = track->valid ? (uint16_t)((track->seq + 1) & MESHXT_POSITION_SEQ_MAX) : 0;
+    size_t o = 0;
+    if (outCap < MESHXT_POSITION_HEADER) return -1;
+    out[o++] = (uint8_t)((key ? MESHXT_POSITION_KEYFRAME : 0) | present |
+                         (seq & MESHXT_POSITION_SEQ_MASK));
+    out[o++] = (uint8_t)(seq >> 4);
+
+    bool ok;
+    if (key) {
+        ok = put_varint(out, o, outCap, quant->latLonStep) &&
+             put_varint(out, o, outCap, quant->altStep) &&
+             put_varint(out, o, outCap, quant->timeStep) &&
+             put_varint(out, o, outCap, zigzag(lat)) &&
+             put_varint(out, o, outCap, zigzag(lon)) &&
+             (!pos->hasAltitude || put_varint(out, o, outCap, zigzag(alt))) &&
+             (!pos->hasTime || put_varint(out, o, outCap, time));
+    } else {
+        // Differences wrap modulo 2^32; the decoder adds them back the same way
+        ok = put_varint(out, o, outCap, zigzag((int32_t)((uint32_t)lat - (uint32_t)track->lat))) &&
+             put_varint(out, o, outCap, zigzag((int32_t)((uint32_t)lon - (uint32_t)track->lon))) &&
+             (!pos->hasAltitude ||
+              put_varint(out, o, outCap, zigzag((int32_t)((uint32_t)alt - (uint32_t)track->alt)))) &&
+             (!pos->hasTime || put_varint(out, o, outCap, zigzag((int32_t)(time - track->time))));
+    }
+    if (!ok) return -1;
+
+    track->quant    = *quant;
+    track->lat      = lat;
+    track->lon      = lon;
+    track->alt      = alt;
+    track->time     = time;
+    track->flags    = present;
+    track->seq      = seq;
+    track->sinceKey = key ? 0 : (uint8_t)(track->sinceKey + 1);
+    track->valid    = true;
+    return (int)o;
+}
+
+int meshxt_position_decode(MeshXTPositionTrack *track, const uint8_t *in, size_t inLen,
+                           MeshXTPosition *pos) {
+    if (inLen < MESHXT_POSITION_HEADER) return -1;
+
+    uint8_t  flags   = in[0];
+    bool     key     = flags & MESHXT_POSITION_KEYFRAME;
+    uint8_t  present = flags & (MESHXT_POSITION_HAS_ALT | MESHXT_POSITION_HAS_TIME);
+    uint16_t seq     = (uint16_t)(((uint16_t)in[1] << 4) | (flags & MESHXT_POSITION_SEQ_MASK));
+    size_t   i = MESHXT_POSITION_HEADER;
+
+    MeshXTPositionTrack next = *track;
+    uint32_t v[4] = {0, 0, 0, 0};
+
+    if (key) {
+        uint32_t steps[3];
+        for (int k = 0; k < 3; k++) {
+            if (!get_varint32(in, i, inLen, steps[k]) || steps[k] == 0 || steps[k] > 0xFFFF) return -1;
+        }
+        next.quant.latLonStep = (uint16_t)steps[0];
+        next.quant.altStep    = (uint16_t)steps[1];
+        next.quant.timeStep   = (uint16_t)steps[2];
+    } else if (!track->valid || track->flags != present ||
+               seq != ((track->seq + 1) & MESHXT_POSITION_SEQ_MAX)) {
+        track->valid = false;   // Lost a report: deltas are useless until a keyframe
+        return -2;
+    }
+
+    if (!get_varint32(in, i, inLen, v[0]) || !get_varint32(in, i, inLen, v[1])) return -1;
+    if ((present & MESHXT_POSITION_HAS_ALT) && !get_varint32(in, i, inLen, v[2])) return -1;
+    if ((present & MESHXT_POSITION_HAS_TIME) && !get_varint32(in, i, inLen, v[3])) return -1;
+    if (i != inLen) return -1;
+
+    if (key) {
+        next.lat  = unzigzag(v[0]);
+        next.lon  = unzigzag(v[1]);
+        next.alt  = unzigzag(v[2]);
+        next.time = v[3];
+        next.sinceKey = 0;
+    } else {
+        next.lat  = (int32_t)((uint32_t)track->lat + (uint32_t)unzigzag(v[0]));
+        next.lon  = (int32_t)((uint32_t)track->lon + (uint32_t)unzigzag(v[1]));
+        next.alt  = (present & MESHXT_POSITION_HAS_ALT) ?
+                    (int32_t)((uint32_t)track->alt + (uint32_t)unzigzag(v[2])) : 0;
+        next.time = (present & MESHXT_POSITION_HAS_TIME) ? track->time + (uint32_t)unzigzag(v[3]) : 0;
+        next.sinceKey = (uint8_t)(track->sinceKey + 1);
+    }
+    next.flags = present;
+    next.seq   = seq;
+    next.valid = true;
+    *track = next;
+
+    pos->latitudeI   = (int32_t)((int64_t)next.lat * next.quant.latLonStep);
+    pos->longitudeI  = (int32_t)((int64_t)next.lon * next.quant.latLonStep);
+    pos->hasAltitude = present & MESHXT_POSITION_HAS_ALT;
+    pos->altitude    = pos->hasAltitude ? (int32_t)((int64_t)next.alt * next.quant.altStep) : 0;
+    pos->hasTime     = present & MESHXT_POSITION_HAS_TIME;
+    pos->time        = pos->hasTime ? next.time * next.quant.timeStep : 0;
+    return 0;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * MeshXT compact position reports
+ *
+ * A Meshtastic Position (PORTNUM_POSITION_APP protobuf) is quantized to a
+ * configurable grid and coded against the previous report from the same
+ * node. Most reports from a moving hiker become a 4-6 byte delta; every
+ * Nth report, and any report the encoder cannot delta (new node, changed
+ * steps or fields), is a keyframe with absolute values.
+ *
+ * Body (MX payload mode MESHXT_MODE_POSITION):
+ *   Byte 0:    [KATx SSSS] Keyframe | Altitude present | Time present |
+ *              reserved | Sequence, low 4 bits
+ *   Byte 1:    Sequence, high 8 bits (12 bits, +1 per report of the node)
+ *   Keyframe:  varint lat/lon step (1e-7 deg), varint altitude step (m),
+ *              varint time step (s), zigzag lat, zigzag lon,
+ *              [zigzag altitude], [varint time]        (quantized values)
+ *   Delta:     zigzag dlat, zigzag dlon, [zigzag daltitude], [zigzag dtime]
+ *
+ * Deltas are taken between quantized values, so rounding never drifts.
+ * The decoder keeps the same per-node state; a sequence gap (lost frame)
+ * invalidates it until the next keyframe. A gap goes unseen only if a
+ * multiple of 4096 reports in a row are lost.
+ */
+
+#define MESHXT_POSITION_MAX_BODY  32   // Largest keyframe
+#define MESHXT_POSITION_HEADER    2    // Flags and sequence
+
+// Byte 0 flags
+#define MESHXT_POSITION_KEYFRAME  0x80
+#define MESHXT_POSITION_HAS_ALT   0x40
+#define MESHXT_POSITION_HAS_TIME  0x20
+#define MESHXT_POSITION_SEQ_MASK  0x0F   // Byte 0 bits of the sequence
+#define MESHXT_POSITION_SEQ_MAX   0x0FFF
+
+/**
+ * Absolute fix, in Meshtastic units.
+ */
+typedef struct {
+    int32_t  latitudeI;     // 1e-7 degrees
+    int32_t  longitudeI;    // 1e-7 degrees
+    int32_t  altitude;      // Metres above MSL
+    uint32_t time;          // Unix seconds
+    bool     hasAltitude;
+    bool     hasTime;
+} MeshXTPosition;
+
+/**
+ * Quantization steps. Larger steps give smaller deltas and coarser fixes.
+ */
+typedef struct {
+    uint16_t latLonStep;    // 1e-7 degrees (100 = 1e-5 deg, about 1.1 m)
+    uint16_t altStep;       // Metres
+    uint16_t timeStep;      // Seconds
+} MeshXTPositionQuant;
+
+/**
+ * Per-node coding state; the encoder and decoder each keep one per node.
+ */
+typedef struct {
+    uint32_t node;
+    uint32_t lastUsed;      // meshxt_position_track() eviction; 0 = free slot
+    MeshXTPositionQuant quant;
+    int32_t  lat, lon, alt; // Last quantized values
+    uint32_t time;
+    uint8_t  flags;         // HAS_ALT / HAS_TIME of the last report
+    uint16_t seq;
+    uint8_t  sinceKey;      // Deltas since the last keyframe
+    bool     valid;
+} MeshXTPositionTrack;
+
+/**
+ * Parse a Meshtastic Position protobuf (fields 1-4: latitude_i,
+ * longitude_i, altitude, time). Other fields are skipped.
+ *
+ * @return  0 on success, -1 if malformed or latitude/longitude missing
+ */
+int meshxt_position_parse(const uint8_t *pb, size_t len, MeshXTPosition *pos);
+
+/**
+ * Find the state for a node in a fixed table. An unknown node takes the
+ * least recently used slot, which is reset (its next report is a keyframe).
+ *
+ * @param now  Monotonic tick for eviction (e.g. millis())
+ */
+MeshXTPositionTrack *meshxt_position_track(MeshXTPositionTrack *table, size_t count,
+                                           uint32_t node, uint32_t now);
+
+/**
+ * Encode a fix against the node's state and advance the state.
+ *
+ * @param track          State for the reporting node
+ * @param pos            Fix to send
+ * @param quant          Steps to use (a change forces a keyframe)
+ * @param keyframeEvery  Deltas between keyframes (0 = keyframes only)
+ * @param out            Output body
+ * @param outCap         Capacity of out (MESHXT_POSITION_MAX_BODY always fits)
+ * @return               Body length, or -1 on bad steps or if out is too small
+ */
+int meshxt_position_encode(MeshXTPositionTrack *track, const MeshXTPosition *pos,
+                           const MeshXTPositionQuant *quant, uint8_t keyframeEvery,
+                           uint8_t *out, size_t outCap);
+
+/**
+ * Decode a body against the node's state and advance the state.
+ *
+ * @return  0 on success (pos is the absolute fix), -1 if malformed,
+ *          -2 if a delta arrived without a usable reference (wait for the
+ *          next keyframe)
+ */
+int meshxt_position_decode(MeshXTPositionTrack *track, const uint8_t *in, size_t inLen,
+                           MeshXTPosition *pos);
@@ -0,0 +1,24 @@
+#pragma once
+
+/**
+ * Compile-time index sequences (C++11 has no std::index_sequence).
+ *
+ * Used to expand constexpr generator functions into static tables, so
+ * lookup tables are built by the compiler into flash instead of at boot.
+ */
+
+// 0 .. N-1 as a parameter pack; built by halving so depth stays O(log N)
+template<int... I> struct MeshXTSeq {};
+
+template<class A, class B> struct MeshXTSeqCat;
+template<int... A, int... B>
+struct MeshXTSeqCat<MeshXTSeq<A...>, MeshXTSeq<B...> > {
+    typedef MeshXTSeq<A..., ((int)sizeof...(A) + B)...> type;
+};
+
+template<int N> struct MeshXTMakeSeq {
+    typedef typename MeshXTSeqCat<typename MeshXTMakeSeq<N / 2>::type,
+                                  typename MeshXTMakeSeq<N - N / 2>::type>::type type;
+};
+template<> struct MeshXTMakeSeq<0> { typedef MeshXTSeq<> type; };
+template<> struct MeshXTMakeSeq<1> { typedef MeshXTSeq<0> type; };
@@ -0,0 +1,249 @@
+/**
+ * compress_roundtrip — Host-side round-trip check for MeshXTCompress
+ * © Mikoshi Ltd. — Apache 2.0
+ *
+ * Checks decompress(compress(x)) == x for every message in the corpus,
+ * for a list of known regressions (case variants such as "OKay" and
+ * "kNOwn", words next to digits, literal 0xFD/0xFE/0xFF bytes) and for
+ * random messages built from corpus words and raw bytes. Each input goes
+ * through every payload mode that compress() can pick, forced with
+ * compressMode(), and through compress() itself. Prints the first
+ * mismatches in hex and exits non-zero if there were any.
+ *
+ * Build & run (from the repository root):
+ *   g++ -O2 -std=c++11 -Isrc/meshxt tools/compress_roundtrip.cpp \
+ *       src/meshxt/MeshXTCompress.cpp src/meshxt/MeshXTCodebook.cpp \
+ *       src/meshxt/MeshXTEntropy.cpp -o compress_roundtrip
+ *   ./compress_roundtrip [corpus...]       default tools/corpus/mesh_chat.txt;
+ *                                          files ending in .hex hold one
+ *                                          hex-encoded payload per line
+ *   ./compress_roundtrip --random N        N random messages (default 20000)
+ */
+
+#include "MeshXTCompress.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+static const int MAX_MESSAGE = 237;   // Meshtastic text payload limit
+
+static const struct { uint8_t mode; const char *name; } modes[] = {
+    { MESHXT_MODE_RAW,      "raw" },
+    { MESHXT_MODE_DICT,     "dict" },
+    { MESHXT_MODE_RLE,      "rle" },
+    { MESHXT_MODE_CODEBOOK, "codebook" },
+    { MESHXT_MODE_ENTROPY,  "entropy" },
+};
+static const int numModes = sizeof(modes) / sizeof(modes[0]);
+
+// Inputs that broke the dictionary coder once, plus the cases around them
+static const char *const regressions[] = {
+    "okay", "OKay", "OKAY", "Okay", "oKAY", "known", "kNOwn", "KNOWN", "Known", "knowN",
+    "ok OK Ok oK", "Water wAter WATER water WaTeR",
+    "Battery low. BATTERY LOW. battery Low", "Bridge Brokenbridge bridgeBroken",
+    "ok1 1ok 2water water3 42 ok42ok", "water_camp water-camp water.camp",
+    "ok", "O", "k",
+};
+
+static int checked = 0, failures = 0;
+static int encoded[numModes + 1], skipped[numModes + 1];
+
+static void print_hex(const char *label, const uint8_t *p, size_t n) {
+    printf("  %-6s", label);
+    for (size_t i = 0; i < n; i++) printf(" %02X", p[i]);
+    printf("\n");
+}
+
+static void fail(const char *what, const char *mode, const Bytes &in,
+                 const uint8_t *packed, uint16_t packedLen, const uint8_t *out, int outLen) {
+    if (++failures > 10) return;
+    printf("MISMATCH %s mode=%s len=%zu\n", what, mode, in.size());
+    print_hex("in", in.data(), in.size());
+    print_hex("packed", packed, packedLen);
+    if (outLen >= 0) print_hex("out", out, outLen);
+}
+
+static void check_one(MeshXTCompress &codec, int slot, const char *mode, int rc,
+                      const Bytes &in, const uint8_t *packed, uint16_t packedLen) {
+    if (rc != 0) {
+        skipped[slot]++;
+        return;
+    }
+    encoded[slot]++;
+    uint8_t out[MAX_MESSAGE + 1];
+    uint16_t outLen = 0;
+    int r = codec.decompress(packed, packedLen, out, sizeof(out), outLen);
+    if (r != 0) fail("decode error", mode, in, packed, packedLen, NULL, -1);
+    else if (outLen != in.size() || memcmp(out, in.data(), outLen) != 0)
+        fail("wrong output", mode, in, packed, packedLen, out, outLen);
+}
+
+static void check(MeshXTCompress &codec, const Bytes &in) {
+    if (in.empty() || in.size() > MAX_MESSAGE) return;
+    checked++;
+
+    // A forced codec may expand the message (dictionary escapes double 0xFD-0xFF)
+    uint8_t packed[2 * MAX_MESSAGE + 16];
+    uint16_t packedLen = 0;
+    for (int m = 0; m < numModes; m++) {
+        int rc = codec.compressMode(modes[m].mode, in.data(), (uint16_t)in.size(),
+                                    packed, sizeof(packed), packedLen);
+        check_one(codec, m, modes[m].name, rc, in, packed, packedLen);
+    }
+
+    int rc = codec.compress(in.data(), (uint16_t)in.size(), packed, packedLen);
+    if (rc == 0 && packedLen > in.size() + MESHXT_COMPRESS_HEADER_SIZE) {
+        fail("expanded", "auto", in, packed, packedLen, NULL, -1);
+    }
+    check_one(codec, numModes, "auto", rc, in, packed, packedLen);
+}
+
+static Bytes from_string(const std::string &s) {
+    return Bytes(s.begin(), s.end());
+}
+
+static bool read_corpus(const char *path, std::vector<Bytes> &messages) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    size_t pathLen = strlen(path);
+    bool hex = pathLen > 4 && strcmp(path + pathLen - 4, ".hex") == 0;
+
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        size_t n = strcspn(line, "\r\n");
+        line[n] = 0;
+        if (n == 0 || line[0] == '#') continue;
+        Bytes msg;
+        if (hex) {
+            for (size_t i = 0; i + 1 < n; i += 2) {
+                unsigned b;
+                if (sscanf(line + i, "%2x", &b) != 1) break;
+                msg.push_back((uint8_t)b);
+            }
+        } else {
+            msg.assign(line, line + n);
+        }
+        messages.push_back(msg);
+    }
+    fclose(f);
+    return true;
+}
+
+// Words of the corpus, split on anything that is not a letter
+static std::vector<std::string> corpus_words(const std::vector<Bytes> &messages) {
+    std::vector<std::string> words;
+    for (const Bytes &m : messages) {
+        std::string w;
+        for (size_t i = 0; i <= m.size(); i++) {
+            uint8_t c = i < m.size() ? m[i] : ' ';
+            if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') {
+                w += (char)c;
+            } else if (!w.empty()) {
+                words.push_back(w);
+                w.clear();
+            }
+        }
+    }
+    return words;
+}
+
+// Corpus words in random case, glued by spaces, punctuation, digits and
+// the dictionary's lead bytes; now and then a run or a raw byte
+static Bytes random_message(const std::vector<std::string> &words) {
+    static const uint8_t glue[] = { ' ', ' ', ' ', ',', '.', '!', '?', '-', '\n',
+                                    '0', '7', 0x00, 0xFD, 0xFE, 0xFF };
+    Bytes msg;
+    size_t target = 1 + rand() % MAX_MESSAGE;
+    while (msg.size() < target) {
+        int pick = rand() % 10;
+        if (pick < 6 && !words.empty()) {
+            std::string w = words[rand() % words.size()];
+            int style = rand() % 5;
+            for (size_t i = 0; i < w.size(); i++) {
+                char c = w[i] | 0x20;
+                bool upper = style == 1 || (style == 2 && i == 0) ||
+                             (style == 3 && (rand() & 1));
+                w[i] = upper ? (char)(c - 32) : c;
+            }
+            msg.insert(msg.end(), w.begin(), w.end());
+        } else if (pick < 9) {
+            msg.push_back(glue[rand() % sizeof(glue)]);
+        } else if (pick == 9 && (rand() & 1)) {
+            msg.insert(msg.end(), 3 + rand() % 20, (uint8_t)rand());
+        } else {
+            msg.push_back((uint8_t)rand());
+        }
+    }
+    msg.resize(target);
+    return msg;
+}
+
+int main(int argc, char **argv) {
+    std::vector<const char *> paths;
+    long randomCount = 20000;
+
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--random") == 0 && a + 1 < argc) {
+            randomCount = atol(argv[++a]);
+        } else if (argv[a][0] == '-') {
+            fprintf(stderr, "usage: %s [--random N] [corpus...]\n", argv[0]);
+            return 2;
+        } else {
+            paths.push_back(argv[a]);
+        }
+    }
+    if (paths.empty()) paths.push_back("tools/corpus/mesh_chat.txt");
+
+    std::vector<Bytes> corpus;
+    for (const char *p : paths) {
+        if (!read_corpus(p, corpus)) return 2;
+    }
+
+    MeshXTCompress codec;
+
+    for (const Bytes &m : corpus) check(codec, m);
+
+    for (const char *r : regressions) check(codec, from_string(r));
+
+    // Literal lead bytes alone, at either end, doubled, and next to words
+    static const uint8_t leads[] = { 0xFD, 0xFE, 0xFF };
+    for (uint8_t a : leads) {
+        check(codec, Bytes(1, a));
+        check(codec, Bytes(5, a));
+        for (uint8_t b : leads) {
+            check(codec, Bytes{ a, b });
+            check(codec, Bytes{ a, 0x00, b });
+            Bytes w = from_string("ok");
+            w.insert(w.begin(), a);
+            w.push_back(b);
+            check(codec, w);
+            w = from_string("water ok");
+            w.insert(w.begin() + 5, a);
+            w.push_back(b);
+            check(codec, w);
+        }
+    }
+
+    std::vector<std::string> words = corpus_words(corpus);
+    srand(42);
+    for (long i = 0; i < randomCount; i++) check(codec, random_message(words));
+
+    printf("%d messages\n", checked);
+    printf("%-10s %8s %8s\n", "mode", "encoded", "skipped");
+    for (int m = 0; m <= numModes; m++) {
+        printf("%-10s %8d %8d\n", m < numModes ? modes[m].name : "auto", encoded[m], skipped[m]);
+    }
+    if (failures) {
+        printf("%d round-trip failures\n", failures);
+        return 1;
+    }
+    printf("all round trips exact\n");
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * duplicate_check — Host-side check of DuplicateFilter against an exact set
+ * © Mikoshi Ltd. — Apache 2.0
+ *
+ * Plays mesh arrivals through the gateway's ingest steps: seen() drops a
+ * copy, otherwise the packet is queued, and record() runs only if that
+ * worked. New packets and rebroadcast copies (some older than the
+ * window) arrive at random, and a share of the packets fail to queue.
+ * An exact map of recorded pairs gives the right answer for every
+ * arrival:
+ *   - false positive: a copy dropped that was never recorded, or whose
+ *     record aged out. This must never happen, and fails the run;
+ *   - false negative: a recorded copy let through, which only happens
+ *     once more pairs are live than the table holds.
+ *
+ * Runs a quiet mesh, where the live pairs fit DUPLICATE_FILTER_SLOTS, and
+ * a busy one, where they do not.
+ *
+ * Build & run (from the repository root):
+ *   g++ -O2 -std=c++11 -Isrc/gateway tools/duplicate_check.cpp \
+ *       src/gateway/DuplicateFilter.cpp -o duplicate_check
+ *   ./duplicate_check [--arrivals N] [--fail PERCENT]
+ */
+
+#include "DuplicateFilter.h"
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utility>
+#include <vector>
+
+typedef std::pair<uint32_t, uint32_t> Key;  // (source, packet id)
+
+struct Result {
+    long copies;
+    long dropped;
+    long falsePositives;
+    long falseNegatives;
+};
+
+/**
+ * @param gapMs    Mean time between arrivals
+ * @param failPct  Share of packets that fail to queue
+ */
+static Result run(long arrivals, uint32_t gapMs, int failPct) {
+    static DuplicateFilter filter;
+    filter = DuplicateFilter();
+    std::map<Key, uint32_t> recorded;     // Pair -> last recorded or matched
+    std::vector<std::pair<Key, uint32_t> > heard;  // Pairs and when first heard
+    uint32_t nextId[64] = {};
+    uint32_t now = 1;
+    Result r = {};
+
+    for (long i = 0; i < arrivals;) {
+        now += 1 + rand() % (2 * gapMs);
+
+        // A new packet, or a copy of one heard up to 1.5 windows ago
+        Key key;
+        if (heard.empty() || rand() % 3 == 0) {
+            uint32_t source = 0x1000 + rand() % 64;
+            key = Key(source, ++nextId[source - 0x1000]);
+            heard.push_back(std::make_pair(key, now));
+        } else {
+            size_t back = 1 + rand() % (heard.size() < 400 ? heard.size() : 400);
+            const std::pair<Key, uint32_t> &h = heard[heard.size() - back];
+            if (now - h.second > DUPLICATE_WINDOW_MS + DUPLICATE_WINDOW_MS / 2) continue;
+            key = h.first;
+            r.copies++;
+        }
+        i++;
+        if (heard.size() > 4096) heard.erase(heard.begin(), heard.begin() + 2048);
+
+        std::map<Key, uint32_t>::iterator it = recorded.find(key);
+        bool expected = it != recorded.end() && now - it->second <= DUPLICATE_WINDOW_MS;
+
+        if (filter.seen(key.first, key.second, now)) {
+            r.dropped++;
+            if (!expected) r.falsePositives++;
+            else it->second = now;
+            continue;
+        }
+        if (expected) r.falseNegatives++;
+
+        if (rand() % 100 < failPct) continue;   // Translation failed or queue full
+        filter.record(key.first, key.second, now);
+        recorded[key] = now;
+    }
+    return r;
+}
+
+int main(int argc, char **argv) {
+    long arrivals = 500000;
+    int failPct = 20;
+    for (int a = 1; a < argc; a++) {
+        if (a + 1 < argc && strcmp(argv[a], "--arrivals") == 0)  arrivals = atol(argv[++a]);
+        else if (a + 1 < argc && strcmp(argv[a], "--fail") == 0) failPct = atoi(argv[++a]);
+        else {
+            fprintf(stderr, "usage: %s [--arrivals N] [--fail PERCENT]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    static const struct { const char *name; uint32_t gapMs; } meshes[] = {
+        { "quiet", 5000 },
+        { "busy",  500 },
+    };
+
+    srand(42);
+    bool ok = true;
+    printf("%ld arrivals, %d%% fail to queue, %d slots, %u ms window\n",
+           arrivals, failPct, DUPLICATE_FILTER_SLOTS, (unsigned)DUPLICATE_WINDOW_MS);
+    printf("%-8s %8s %8s %10s %10s %10s\n", "mesh", "gap ms", "copies", "dropped",
+           "false pos", "false neg");
+    for (size_t m = 0; m < sizeof(meshes) / sizeof(meshes[0]); m++) {
+        Result r = run(arrivals, meshes[m].gapMs, failPct);
+        printf("%-8s %8u %8ld %10ld %10ld %10ld\n", meshes[m].name, meshes[m].gapMs,
+               r.copies, r.dropped, r.falsePositives, r.falseNegatives);
+        if (r.falsePositives) ok = false;
+    }
+    if (!ok) {
+        printf("FAIL: copies dropped that were not recorded within the window\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,391 @@
+/**
+ * fec_bench — Host-side benchmark for the MeshXT Reed-Solomon codec
+ * © Mikoshi Ltd. — Apache 2.0
+ *
+ * Reports, for every FEC level:
+ *   - encode and decode throughput (ns/packet and MB/s of payload) for
+ *     payload sizes 10-191 bytes, scalar and vector backends, with the
+ *     original v0.1 encoder as the baseline;
+ *   - decode success rate against injected random symbol errors, burst
+ *     errors and erasures, split into corrected / detected / miscorrected.
+ * Before timing anything it checks that every kernel set built for this
+ * architecture and supported by the CPU (SSSE3, AVX2, NEON) is
+ * bit-identical to the scalar codec and the reference, and exits non-zero
+ * on the first mismatch.
+ *
+ * Build & run (from the repository root):
+ *   g++ -O2 -std=c++11 -Isrc/meshxt tools/fec_bench.cpp \
+ *       src/meshxt/MeshXTFEC.cpp src/meshxt/MeshXTFECSimd.cpp -o fec_bench
+ *   ./fec_bench            human-readable tables
+ *   ./fec_bench --csv      one CSV row per measurement
+ *   ./fec_bench --json     JSON array of the same records
+ *   ./fec_bench --quick    fewer iterations/trials (smoke test)
+ */
+
+#include "MeshXTFEC.h"
+#include "MeshXTFECKernels.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------
+// Reference: v0.1 encoder, kept verbatim for before/after timing
+// ------------------------------------------------------------
+
+static uint8_t ref_exp[512];
+static uint8_t ref_log[256];
+static bool ref_initialized = false;
+
+static void ref_init(void) {
+    if (ref_initialized) return;
+    int x = 1;
+    for (int i = 0; i < 255; i++) {
+        ref_exp[i] = (uint8_t)x;
+        ref_log[x] = (uint8_t)i;
+        x <<= 1;
+        if (x & 0x100) x ^= 0x11D;
+    }
+    for (int i = 255; i < 512; i++) {
+        ref_exp[i] = ref_exp[i - 255];
+    }
+    ref_initialized = true;
+}
+
+static inline uint8_t ref_mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) return 0;
+    return ref_exp[ref_log[a] + ref_log[b]];
+}
+
+static int ref_encode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym) {
+    ref_init();
+    if (dataLen + nsym > 255) return -1;
+
+    uint8_t gen[65];
+    memset(gen, 0, sizeof(gen));
+    gen[0] = 1;
+    int genLen = 1;
+    for (int i = 0; i < nsym; i++) {
+        for (int j = genLen; j > 0; j--) {
+            gen[j] = gen[j - 1] ^ ref_mul(gen[j], ref_exp[i]);
+        }
+        gen[0] = ref_mul(gen[0], ref_exp[i]);
+        genLen++;
+    }
+
+    uint8_t reg[65];
+    memset(reg, 0, nsym);
+    for (size_t i = 0; i < dataLen; i++) {
+        uint8_t feedback = data[i] ^ reg[0];
+        for (int j = 0; j < nsym - 1; j++) {
+            reg[j] = reg[j + 1] ^ ref_mul(gen[nsym - 1 - j], feedback);
+        }
+        reg[nsym - 1] = ref_mul(gen[0], feedback);
+    }
+
+    memcpy(output, data, dataLen);
+    memcpy(output + dataLen, reg, nsym);
+    return (int)(dataLen + nsym);
+}
+
+// ------------------------------------------------------------
+// Output
+// ------------------------------------------------------------
+
+enum OutputFormat { OUTPUT_TEXT, OUTPUT_CSV, OUTPUT_JSON };
+
+static OutputFormat outFormat = OUTPUT_TEXT;
+static bool firstRecord = true;
+
+static void begin_section(const char *title, const char *columns) {
+    if (outFormat == OUTPUT_TEXT) printf("\n%s\n%s\n", title, columns);
+}
+
+static void begin_record(void) {
+    if (outFormat == OUTPUT_JSON) {
+        printf(firstRecord ? "[\n  " : ",\n  ");
+    }
+    firstRecord = false;
+}
+
+static void emit_throughput(const char *op, const char *backend, int nsym, size_t bytes, double ns) {
+    double mbps = ns > 0 ? bytes * 1000.0 / ns : 0;
+    switch (outFormat) {
+        case OUTPUT_TEXT:
+            printf("%-10s %-8s %-6d %-6zu %12.1f %10.2f\n", op, backend, nsym, bytes, ns, mbps);
+            break;
+        case OUTPUT_CSV:
+            printf("throughput,%s,%s,%d,%zu,%.1f,%.2f,,,,,\n", op, backend, nsym, bytes, ns, mbps);
+            break;
+        case OUTPUT_JSON:
+            begin_record();
+            printf("{\"test\":\"throughput\",\"op\":\"%s\",\"backend\":\"%s\",\"nsym\":%d,"
+                   "\"bytes\":%zu,\"ns_per_packet\":%.1f,\"mb_per_s\":%.2f}",
+                   op, backend, nsym, bytes, ns, mbps);
+            break;
+    }
+}
+
+static void emit_capability(const char *pattern, int nsym, int symbols, int trials,
+                            int corrected, int detected, int miscorrected) {
+    double rate = trials ? 100.0 * corrected / trials : 0;
+    switch (outFormat) {
+        case OUTPUT_TEXT:
+            printf("%-10s %-6d %-8d %8d %10d %10d %12d %8.1f%%\n", pattern, nsym, symbols, trials,
+                   corrected, detected, miscorrected, rate);
+            break;
+        case OUTPUT_CSV:
+            printf("capability,%s,,%d,,,,%d,%d,%d,%d,%d\n", pattern, nsym, symbols, trials,
+                   corrected, detected, miscorrected);
+            break;
+        case OUTPUT_JSON:
+            begin_record();
+            printf("{\"test\":\"capability\",\"pattern\":\"%s\",\"nsym\":%d,\"symbols\":%d,"
+                   "\"trials\":%d,\"corrected\":%d,\"detected\":%d,\"miscorrected\":%d}",
+                   pattern, nsym, symbols, trials, corrected, detected, miscorrected);
+            break;
+    }
+}
+
+// ------------------------------------------------------------
+// Timing
+// ------------------------------------------------------------
+
+typedef int (*EncodeFn)(const uint8_t *, size_t, uint8_t *, uint8_t);
+
+static volatile uint8_t sink;
+
+static double ns_per_packet(EncodeFn fn, const uint8_t *data, size_t len, uint8_t nsym, int iters) {
+    uint8_t out[256];
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iters; i++) {
+        fn(data, len, out, nsym);
+        sink ^= out[len];
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / iters;
+}
+
+static double ns_per_decode(const uint8_t *cw, size_t len, uint8_t nsym, int iters) {
+    uint8_t out[256];
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iters; i++) {
+        meshxt_fec_decode(cw, len, out, nsym);
+        sink ^= out[0];
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / iters;
+}
+
+// Vector kernel sets, checked and timed when the CPU has them
+static const struct { uint8_t id; const char *name; } vectorBackends[] = {
+    { MESHXT_FEC_BACKEND_SSSE3, "ssse3" },
+    { MESHXT_FEC_BACKEND_AVX2,  "avx2" },
+    { MESHXT_FEC_BACKEND_NEON,  "neon" },
+};
+
+/**
+ * A vector backend must match the scalar codec byte for byte: parity for
+ * every level and length, syndromes of arbitrary (non-codeword) buffers
+ * for every nsym, and decode results of corrupted codewords.
+ */
+static bool check_backend(const uint8_t *data, uint8_t backend) {
+    static const uint8_t levels[] = { MESHXT_FEC_LOW, MESHXT_FEC_MEDIUM, MESHXT_FEC_HIGH };
+
+    for (uint8_t nsym : levels) {
+        for (size_t len = 1; len + nsym <= 255; len++) {
+            uint8_t a[256], b[256];
+            ref_encode(data, len, a, nsym);
+            meshxt_fec_set_backend(MESHXT_FEC_BACKEND_SCALAR);
+            meshxt_fec_encode(data, len, b, nsym);
+            if (memcmp(a, b, len + nsym) != 0) {
+                printf("MISMATCH scalar encode nsym=%d len=%zu\n", nsym, len);
+                return false;
+            }
+            meshxt_fec_set_backend(backend);
+            meshxt_fec_encode(data, len, b, nsym);
+            if (memcmp(a, b, len + nsym) != 0) {
+                printf("MISMATCH %s encode nsym=%d len=%zu\n", meshxt_fec_backend_name(), nsym, len);
+                return false;
+            }
+        }
+    }
+
+    for (uint8_t nsym = 1; nsym <= 64; nsym++) {
+        for (size_t len = 1; len <= 255; len++) {
+            uint8_t sa[64], sb[64];
+            meshxt_fec_set_backend(MESHXT_FEC_BACKEND_SCALAR);
+            meshxt_fec_syndromes(data, len, nsym, sa);
+            meshxt_fec_set_backend(backend);
+            meshxt_fec_syndromes(data, len, nsym, sb);
+            if (memcmp(sa, sb, nsym) != 0) {
+                printf("MISMATCH %s syndromes nsym=%d len=%zu\n", meshxt_fec_backend_name(), nsym, len);
+                return false;
+            }
+        }
+    }
+
+    for (int t = 0; t < 3000; t++) {
+        uint8_t nsym = levels[t % 3];
+        size_t len = 1 + rand() % (255 - nsym);
+        uint8_t cw[256], oa[256], ob[256], ca, cb;
+        meshxt_fec_encode(data, len, cw, nsym);
+        int errors = rand() % (nsym / 2 + 4);
+        for (int e = 0; e < errors; e++) cw[rand() % (len + nsym)] ^= (uint8_t)(1 + rand() % 255);
+        meshxt_fec_set_backend(MESHXT_FEC_BACKEND_SCALAR);
+        int ra = meshxt_fec_decode_erasures(cw, len + nsym, oa, nsym, NULL, 0, &ca);
+        meshxt_fec_set_backend(backend);
+        int rb = meshxt_fec_decode_erasures(cw, len + nsym, ob, nsym, NULL, 0, &cb);
+        if (ra != rb || ca != cb || (ra > 0 && memcmp(oa, ob, ra) != 0)) {
+            printf("MISMATCH %s decode nsym=%d len=%zu\n", meshxt_fec_backend_name(), nsym, len);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Correction capability
+// ------------------------------------------------------------
+
+enum FaultPattern { FAULT_RANDOM, FAULT_BURST, FAULT_ERASURE };
+
+static const char *const patternNames[] = { "random", "burst", "erasure" };
+
+/**
+ * Corrupt a fresh codeword with the given pattern and count how often the
+ * decoder restores it, reports failure, or returns the wrong message.
+ * Errors hit distinct random positions; a burst is one contiguous run;
+ * erasures are distinct positions passed to the decoder (half of them
+ * are left intact, as a real receiver flags doubtful bytes).
+ */
+static void run_capability(FaultPattern pattern, uint8_t nsym, size_t len, int symbols, int trials) {
+    int corrected = 0, detected = 0, miscorrected = 0;
+    size_t n = len + nsym;
+
+    for (int t = 0; t < trials; t++) {
+        uint8_t msg[255], cw[256], out[256], pos[255], erasures[64];
+        for (size_t i = 0; i < len; i++) msg[i] = (uint8_t)rand();
+        meshxt_fec_encode(msg, len, cw, nsym);
+
+        for (size_t i = 0; i < n; i++) pos[i] = (uint8_t)i;
+        for (size_t i = 0; i < n; i++) {
+            size_t j = i + rand() % (n - i);
+            uint8_t x = pos[i]; pos[i] = pos[j]; pos[j] = x;
+        }
+
+        uint8_t numErasures = 0;
+        switch (pattern) {
+            case FAULT_RANDOM:
+                for (int e = 0; e < symbols; e++) cw[pos[e]] ^= (uint8_t)(1 + rand() % 255);
+                break;
+            case FAULT_BURST: {
+                size_t start = rand() % (n - symbols + 1);
+                for (int e = 0; e < symbols; e++) cw[start + e] ^= (uint8_t)(1 + rand() % 255);
+                break;
+            }
+            case FAULT_ERASURE:
+                for (int e = 0; e < symbols && e < 64; e++) {
+                    if (rand() & 1) cw[pos[e]] ^= (uint8_t)(1 + rand() % 255);
+                    erasures[numErasures++] = pos[e];
+                }
+                break;
+        }
+
+        int r = meshxt_fec_decode_erasures(cw, n, out, nsym, erasures, numErasures, NULL);
+        if (r < 0) detected++;
+        else if ((size_t)r == len && memcmp(out, msg, len) == 0) corrected++;
+        else miscorrected++;
+    }
+
+    emit_capability(patternNames[pattern], nsym, symbols, trials, corrected, detected, miscorrected);
+}
+
+int main(int argc, char **argv) {
+    static const uint8_t levels[] = { MESHXT_FEC_LOW, MESHXT_FEC_MEDIUM, MESHXT_FEC_HIGH };
+    static const size_t  sizes[]  = { 10, 32, 64, 100, 128, 160, 191 };
+    bool quick = false;
+
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--csv") == 0)        outFormat = OUTPUT_CSV;
+        else if (strcmp(argv[a], "--json") == 0)  outFormat = OUTPUT_JSON;
+        else if (strcmp(argv[a], "--quick") == 0) quick = true;
+        else {
+            fprintf(stderr, "usage: %s [--csv|--json] [--quick]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Enough iterations for ~1 MB of payload per measurement
+    const long budget = quick ? 100000 : 1000000;
+    const int  trials = quick ? 100 : 1000;
+
+    uint8_t data[255];
+    srand(42);
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)rand();
+
+    // Bit-exactness first: a faster codec that changes parity is a protocol break
+    uint8_t backends[4] = { MESHXT_FEC_BACKEND_SCALAR };
+    int numBackends = 1;
+    for (const auto &v : vectorBackends) {
+        if (!meshxt_fec_set_backend(v.id)) {
+            if (outFormat == OUTPUT_TEXT) {
+                printf("%s: not in this build or not supported by this CPU\n", v.name);
+            }
+            continue;
+        }
+        if (!check_backend(data, v.id)) return 1;
+        if (outFormat == OUTPUT_TEXT) printf("%s: bit-identical to scalar\n", v.name);
+        backends[numBackends++] = v.id;
+    }
+    if (outFormat == OUTPUT_CSV) {
+        printf("test,case,backend,nsym,bytes,ns_per_packet,mb_per_s,"
+               "symbols,trials,corrected,detected,miscorrected\n");
+    }
+
+    begin_section("Throughput (bytes = payload; decode with nsym/4 symbol errors)",
+                  "op         backend  nsym   bytes  ns/packet        MB/s");
+    for (uint8_t nsym : levels) {
+        for (size_t len : sizes) {
+            int iters = (int)(budget / len);
+
+            emit_throughput("encode", "v0.1", nsym, len, ns_per_packet(ref_encode, data, len, nsym, iters));
+
+            uint8_t clean[256], noisy[256];
+            meshxt_fec_encode(data, len, clean, nsym);
+            memcpy(noisy, clean, len + nsym);
+            for (int e = 0; e < nsym / 4; e++) noisy[(e * 37 + 5) % (len + nsym)] ^= (uint8_t)(0x5A + e);
+
+            for (int b = 0; b < numBackends; b++) {
+                meshxt_fec_set_backend(backends[b]);
+                const char *name = meshxt_fec_backend_name();
+                emit_throughput("encode", name, nsym, len,
+                                ns_per_packet(meshxt_fec_encode, data, len, nsym, iters));
+                emit_throughput("decode", name, nsym, len, ns_per_decode(clean, len + nsym, nsym, iters));
+                emit_throughput("correct", name, nsym, len, ns_per_decode(noisy, len + nsym, nsym, iters));
+            }
+        }
+    }
+
+    // Sample each pattern at fractions of the capacity and just past it
+    begin_section("Correction capability (100-byte payload)",
+                  "pattern    nsym   symbols    trials  corrected   detected miscorrected     rate");
+    meshxt_fec_set_backend(MESHXT_FEC_BACKEND_AUTO);
+    for (uint8_t nsym : levels) {
+        for (int p = FAULT_RANDOM; p <= FAULT_ERASURE; p++) {
+            int capacity = (p == FAULT_ERASURE) ? nsym : nsym / 2;
+            int points[] = { 0, capacity / 4, capacity / 2, 3 * capacity / 4, capacity,
+                             capacity + 1, capacity + 2, capacity + 4 };
+            for (int symbols : points) {
+                if (p == FAULT_ERASURE && symbols > nsym) {
+                    // The decoder takes at most nsym erasures; beyond that it is a caller error
+                    continue;
+                }
+                run_capability((FaultPattern)p, nsym, 100, symbols, trials);
+            }
+        }
+    }
+
+    if (outFormat == OUTPUT_JSON) printf(firstRecord ? "[]\n" : "\n]\n");
+    return 0;
+}
@@ -0,0 +1,416 @@
+#!/usr/bin/env python3
+"""
+gen_codebook — Train the compiled-in MeshXT dictionary and codebook
+(c) Mikoshi Ltd. — Apache 2.0
+
+Reads a corpus of mesh messages and writes two generated headers:
+
+  src/meshxt/MeshXTDictTable.h      Word dictionary for MeshXTCompress
+  src/meshxt/MeshXTCodebookTable.h  254-entry substring codebook
+
+Corpus files are plain text, one message per line ('#' comments), or
+payload captures with one hex-encoded payload per line (files ending in
+.hex, or any file with --hex). Every Nth message is held out to report
+the ratio on unseen text; the emitted tables are then trained on the
+whole corpus.
+
+Usage (from the repository root):
+    python3 tools/gen_codebook.py [corpus...] [--version N] [--holdout N]
+
+The encoders below mirror MeshXTCompress::dictCompress and
+meshxt_compress_bytes; keep them in step. Bump --version whenever the
+output changes: packets coded with one table cannot be decoded with
+another. MeshXTCompress.cpp then refuses to build until
+MESHXT_FORMAT_VERSION is bumped to match.
+"""
+
+import argparse
+import heapq
+import os
+import sys
+from collections import Counter
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+CODEBOOK_SIZE = 254     # Codes 0x00-0xFD; 0xFE/0xFF are verbatim escapes
+CODEBOOK_MAX_LEN = 16   # static_assert limit in MeshXTCodebook.cpp
+DICT_MAX_WORDS = 254    # Codes 0x01-0xFE; 0x00 and 0xFF are reserved
+DICT_MIN_LEN = 3        # A dictionary hit costs 2 bytes
+
+
+# ------------------------------------------------------------
+# Corpus
+# ------------------------------------------------------------
+
+def read_corpus(paths, force_hex):
+    messages = []
+    for path in paths:
+        is_hex = force_hex or path.endswith(".hex")
+        with open(path, "rb") as f:
+            for raw in f:
+                line = raw.rstrip(b"\r\n")
+                if not line or line.startswith(b"#"):
+                    continue
+                if is_hex:
+                    try:
+                        line = bytes.fromhex(line.decode("ascii"))
+                    except ValueError:
+                        sys.exit("%s: bad hex line: %r" % (path, line[:40]))
+                    if not line:
+                        continue
+                messages.append(line)
+    return messages
+
+
+def split(messages, holdout):
+    if holdout <= 1:
+        return messages, []
+    train = [m for i, m in enumerate(messages) if i % holdout != holdout - 1]
+    test = [m for i, m in enumerate(messages) if i % holdout == holdout - 1]
+    return train, test
+
+
+# ------------------------------------------------------------
+# Encoders (sizes only)
+# ------------------------------------------------------------
+
+def codebook_size(book, msg, max_len):
+    """Bytes meshxt_compress_bytes produces: longest match, verbatim runs."""
+    out = 0
+    lit = 0
+    i = 0
+    n = len(msg)
+    while i < n:
+        hit = 0
+        for l in range(min(max_len, n - i), 0, -1):
+            if msg[i:i + l] in book:
+                hit = l
+                break
+        if not hit:
+            lit += 1
+            i += 1
+            if lit == 256:
+                out += 2 + lit
+                lit = 0
+            continue
+        if lit:
+            out += (1 if lit == 1 else 2) + lit
+            lit = 0
+        out += 1
+        i += hit
+    if lit:
+        out += (1 if lit == 1 else 2) + lit
+    return out
+
+
+def codebook_usage(book, messages, max_len):
+    used = Counter()
+    for msg in messages:
+        i = 0
+        n = len(msg)
+        while i < n:
+            for l in range(min(max_len, n - i), 0, -1):
+                if msg[i:i + l] in book:
+                    used[msg[i:i + l]] += 1
+                    i += l
+                    break
+            else:
+                i += 1
+    return used
+
+
+def is_word_char(b):
+    return 0x41 <= b <= 0x5A or 0x61 <= b <= 0x7A or 0x30 <= b <= 0x39
+
+
+def case_ok(word):
+    return word.islower() or word.isupper() or word.istitle()
+
+
+def dict_size(words, msg, max_len):
+    """Bytes MeshXTCompress::dictCompress produces: whole words in lower,
+    Title or UPPER case become 2-byte tokens; 0xFD-0xFF cost 2 bytes."""
+    up = msg.upper()
+    out = 0
+    i = 0
+    n = len(msg)
+    while i < n:
+        hit = 0
+        if 0x41 <= up[i] <= 0x5A and (i == 0 or not is_word_char(msg[i - 1])):
+            for l in range(min(max_len, n - i), DICT_MIN_LEN - 1, -1):
+                if up[i:i + l] in words and (i + l == n or not is_word_char(msg[i + l])) \
+                        and case_ok(msg[i:i + l]):
+                    hit = l
+                    break
+        if hit:
+            out += 2
+            i += hit
+        else:
+            out += 2 if msg[i] >= 0xFD else 1
+            i += 1
+    return out
+
+
+def total(size_fn, table, messages, max_len):
+    return sum(size_fn(table, m, max_len) for m in messages)
+
+
+# ------------------------------------------------------------
+# Dictionary training
+# ------------------------------------------------------------
+
+def train_dict(messages, max_words):
+    """Whole words, ranked by bytes saved (occurrences x (length - 2))."""
+    counts = Counter()
+    for msg in messages:
+        word = bytearray()
+        for b in msg + b" ":
+            if is_word_char(b):
+                word.append(b)
+                continue
+            w = bytes(word)
+            if len(w) >= DICT_MIN_LEN and w.isalpha() and case_ok(w):
+                counts[w.upper()] += 1
+            word = bytearray()
+
+    ranked = sorted(((c * (len(w) - 2), w) for w, c in counts.items() if c >= 2),
+                    key=lambda t: (-t[0], t[1]))
+    words = [w for score, w in ranked[:max_words] if score > 0]
+
+    # Drop words that cost more than they save once real matching is applied
+    max_len = max((len(w) for w in words), default=DICT_MIN_LEN)
+    chosen = set(words)
+    size = total(dict_size, chosen, messages, max_len)
+    for w in reversed(words):
+        chosen.discard(w)
+        trial = total(dict_size, chosen, messages, max_len)
+        if trial > size:
+            chosen.add(w)
+        else:
+            size = trial
+    return [w for w in words if w in chosen]
+
+
+# ------------------------------------------------------------
+# Codebook training
+# ------------------------------------------------------------
+
+def substring_counts(messages, max_len):
+    counts = Counter()
+    for msg in messages:
+        n = len(msg)
+        for i in range(n):
+            for l in range(1, min(max_len, n - i) + 1):
+                counts[msg[i:i + l]] += 1
+    return counts
+
+
+def greedy_codebook(counts, size, min_count):
+    """Pick by bytes saved; a pick discounts the substrings it covers."""
+    count = {s: c for s, c in counts.items() if c >= min_count or len(s) == 1}
+
+    def score(s):
+        # A single byte saves its verbatim escape; longer strings save len - 1
+        return count[s] * (len(s) - 1 if len(s) > 1 else 1)
+
+    heap = [(-score(s), s) for s in count]
+    heapq.heapify(heap)
+    picked = []
+    ranked = []
+    while heap:
+        neg, s = heapq.heappop(heap)
+        if -neg != score(s):
+            if score(s) > 0:
+                heapq.heappush(heap, (-score(s), s))
+            continue
+        if -neg <= 0:
+            continue
+        ranked.append(s)
+        if len(picked) >= size:
+            continue
+        picked.append(s)
+        for l in range(1, len(s)):
+            for i in range(len(s) - l + 1):
+                t = s[i:i + l]
+                if t in count:
+                    count[t] = max(0, count[t] - count[s])
+    return picked, ranked[len(picked):]
+
+
+def train_codebook(messages, max_len, min_count, iters):
+    counts = substring_counts(messages, max_len)
+    book, spare = greedy_codebook(counts, CODEBOOK_SIZE, min_count)
+    book = set(book)
+    size = total(codebook_size, book, messages, max_len)
+
+    # Local search: swap the least useful entry for the next spare
+    # candidate while that shrinks the corpus
+    spare = [s for s in spare if s not in book]
+    for _ in range(iters):
+        if not spare:
+            break
+        used = codebook_usage(book, messages, max_len)
+        worst = min(book, key=lambda e: (used[e] * max(1, len(e) - 1), -len(e), e))
+        cand = spare.pop(0)
+        book.discard(worst)
+        book.add(cand)
+        trial = total(codebook_size, book, messages, max_len)
+        if trial < size:
+            size = trial
+            spare.append(worst)
+        else:
+            book.discard(cand)
+            book.add(worst)
+
+    # Fill unused slots with the most common remaining bytes so every code
+    # is assigned
+    if len(book) < CODEBOOK_SIZE:
+        for s, _ in counts.most_common():
+            if len(book) >= CODEBOOK_SIZE:
+                break
+            book.add(s)
+        for b in range(0x20, 0x7F):
+            if len(book) >= CODEBOOK_SIZE:
+                break
+            book.add(bytes([b]))
+    return book
+
+
+# ------------------------------------------------------------
+# Output
+# ------------------------------------------------------------
+
+def c_string(s):
+    out = []
+    prev = 0
+    for b in s:
+        if b == 0x22:
+            out.append('\\"')
+        elif b == 0x5C:
+            out.append("\\\\")
+        elif b == 0x3F and prev == 0x3F:
+            out.append("\\?")   # No trigraphs
+        elif 0x20 <= b <= 0x7E:
+            out.append(chr(b))
+        else:
+            out.append("\\%03o" % b)
+        prev = b
+    return '"' + "".join(out) + '"'
+
+
+def table_order(entries):
+    # First byte, then longest first: the matchers take the first hit in a
+    # first-byte bucket as the longest match
+    return sorted(entries, key=lambda s: (s[0], -len(s), s))
+
+
+def macro_lines(items, width=96):
+    lines = []
+    line = "   "
+    for item in items:
+        if len(line) + len(item) + 2 > width:
+            lines.append(line + " \\")
+            line = "   "
+        line += " " + item + ","
+    lines.append(line)
+    return lines
+
+
+def emit_header(path, tool_args, version_macro, version, ratio_note, body):
+    lines = [
+        "#pragma once",
+        "",
+        "// Generated by tools/gen_codebook.py from %s — do not edit." % tool_args,
+        "// %s" % ratio_note,
+        "",
+        "#define %s %d" % (version_macro, version),
+        "",
+    ] + body + [""]
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+
+def emit_codebook(path, book, sources, version, ratio):
+    entries = ["CB(%s)" % c_string(s) for s in table_order(book)]
+    body = [
+        "// Code = position in this list; CB() is defined by MeshXTCodebook.cpp",
+        "#define MESHXT_CODEBOOK_ENTRIES \\",
+    ] + macro_lines(entries)
+    emit_header(path, sources, "MESHXT_CODEBOOK_VERSION", version,
+                "Expected size on the corpus: %.1f%% of the input." % (ratio * 100), body)
+
+
+def emit_dict(path, words, sources, version, ratio):
+    # Wire code by rank: the most valuable word gets 0x01
+    codes = {w: i + 1 for i, w in enumerate(words)}
+    entries = ["DICT_WORD(%s, 0x%02X)" % (c_string(w), codes[w]) for w in table_order(words)]
+    body = [
+        "// Upper-case words with their wire codes; DICT_WORD() is defined by MeshXTCompress.cpp",
+        "#define MESHXT_DICT_ENTRIES \\",
+    ] + macro_lines(entries)
+    emit_header(path, sources, "MESHXT_DICT_VERSION", version,
+                "Expected size on the corpus: %.1f%% of the input." % (ratio * 100), body)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("corpus", nargs="*", default=[os.path.join(ROOT, "tools", "corpus", "mesh_chat.txt")])
+    ap.add_argument("--hex", action="store_true", help="corpus files are hex payload captures")
+    ap.add_argument("--version", type=int, default=1)
+    ap.add_argument("--holdout", type=int, default=5, help="hold out every Nth message for the report (0 = none)")
+    ap.add_argument("--max-len", type=int, default=8, help="longest codebook entry")
+    ap.add_argument("--min-count", type=int, default=6,
+                    help="occurrences before a multi-byte string is a codebook candidate; "
+                         "raise it to avoid fitting phrases unique to the corpus")
+    ap.add_argument("--dict-words", type=int, default=64, help="dictionary size limit")
+    ap.add_argument("--iters", type=int, default=300, help="codebook local-search steps")
+    ap.add_argument("--dict-out", default=os.path.join(ROOT, "src", "meshxt", "MeshXTDictTable.h"))
+    ap.add_argument("--codebook-out", default=os.path.join(ROOT, "src", "meshxt", "MeshXTCodebookTable.h"))
+    args = ap.parse_args()
+
+    if not 1 <= args.max_len <= CODEBOOK_MAX_LEN:
+        sys.exit("--max-len must be 1-%d" % CODEBOOK_MAX_LEN)
+    if not 1 <= args.dict_words <= DICT_MAX_WORDS:
+        sys.exit("--dict-words must be 1-%d" % DICT_MAX_WORDS)
+
+    messages = read_corpus(args.corpus, args.hex)
+    if not messages:
+        sys.exit("empty corpus")
+
+    def ratios(train, test):
+        words = train_dict(train, args.dict_words)
+        book = train_codebook(train, args.max_len, args.min_count, args.iters)
+        wl = max((len(w) for w in words), default=DICT_MIN_LEN)
+        out = []
+        for msgs in (train, test):
+            raw = sum(len(m) for m in msgs)
+            if not raw:
+                out.append(None)
+                continue
+            d = total(dict_size, set(words), msgs, wl)
+            c = total(codebook_size, book, msgs, args.max_len)
+            best = sum(min(len(m), dict_size(set(words), m, wl), codebook_size(book, m, args.max_len))
+                       for m in msgs)
+            out.append((d / raw, c / raw, best / raw))
+        return words, book, out
+
+    train, test = split(messages, args.holdout)
+    if test:
+        _, _, (tr, te) = ratios(train, test)
+        print("held out %d of %d messages: dictionary %.1f%%, codebook %.1f%%, best of both %.1f%%"
+              % (len(test), len(messages), te[0] * 100, te[1] * 100, te[2] * 100))
+
+    words, book, (full, _) = ratios(messages, [])
+    sources = ", ".join(os.path.relpath(p, ROOT) for p in args.corpus)
+    emit_dict(args.dict_out, words, sources, args.version, full[0])
+    emit_codebook(args.codebook_out, book, sources, args.version, full[1])
+
+    print("%d messages, %d bytes: dictionary (%d words) %.1f%%, codebook %.1f%%, best of both %.1f%%"
+          % (len(messages), sum(len(m) for m in messages), len(words),
+             full[0] * 100, full[1] * 100, full[2] * 100))
+    for path in (args.dict_out, args.codebook_out):
+        print("wrote %s (version %d)" % (os.path.relpath(path, ROOT), args.version))
+
+
+if __name__ == "__main__":
+    main()
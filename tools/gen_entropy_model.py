@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+"""
+gen_entropy_model — Train the compiled-in MeshXT entropy coder model
+(c) Mikoshi Ltd. — Apache 2.0
+
+Reads a corpus of mesh chat messages (one per line, '#' comments) and
+writes src/meshxt/MeshXTEntropyModel.h: per-context canonical Huffman
+code lengths plus the canonical symbol order. MeshXTEntropy.cpp derives
+the encode/decode tables from these at compile time and static_asserts
+that they form complete prefix codes.
+
+Usage (from the repository root):
+    python3 tools/gen_entropy_model.py [corpus...] [-o header] [--version N]
+
+Contexts must match meshxt_entropy_context() in MeshXTEntropy.cpp.
+Bump --version whenever the output changes: packets coded with one model
+cannot be decoded with another. MeshXTCompress.cpp then refuses to build
+until MESHXT_FORMAT_VERSION is bumped to match.
+"""
+
+import argparse
+import heapq
+import os
+import sys
+
+SYMBOLS = 96          # 95 printable ASCII (0x20-0x7E) + escape
+ESC = 95
+MAX_BITS = 12
+MIN_LONGEST = 8       # tail padding (up to 7 one-bits) must never decode
+CONTEXTS = ["after space/start", "after vowel", "after consonant", "after upper case",
+            "after digit", "after other"]
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+
+def context_of(prev):
+    if prev == 0x20:
+        return 0
+    if prev in b"aeiou":
+        return 1
+    if ord("a") <= prev <= ord("z"):
+        return 2
+    if ord("A") <= prev <= ord("Z"):
+        return 3
+    if ord("0") <= prev <= ord("9"):
+        return 4
+    return 5
+
+
+def symbol_of(byte):
+    return byte - 0x20 if 0x20 <= byte <= 0x7E else ESC
+
+
+def read_corpus(paths):
+    messages = []
+    for path in paths:
+        with open(path, "rb") as f:
+            for raw in f:
+                line = raw.rstrip(b"\r\n")
+                if not line or line.startswith(b"#"):
+                    continue
+                messages.append(line)
+    return messages
+
+
+def count(messages):
+    freq = [[0] * SYMBOLS for _ in CONTEXTS]
+    for msg in messages:
+        prev = 0x20
+        for b in msg:
+            freq[context_of(prev)][symbol_of(b)] += 1
+            prev = b
+    return freq
+
+
+def huffman_lengths(weights):
+    heap = [(w, i, (i,)) for i, w in enumerate(weights)]
+    heapq.heapify(heap)
+    lengths = [0] * len(weights)
+    tie = len(weights)
+    while len(heap) > 1:
+        w1, _, a = heapq.heappop(heap)
+        w2, _, b = heapq.heappop(heap)
+        for s in a + b:
+            lengths[s] += 1
+        heapq.heappush(heap, (w1 + w2, tie, a + b))
+        tie += 1
+    return lengths
+
+
+def limited_lengths(weights, limit):
+    """Length-limited Huffman (package-merge); always a complete code."""
+    lengths = huffman_lengths(weights)
+    if max(lengths) <= limit:
+        return lengths
+    leaves = sorted((w, (i,)) for i, w in enumerate(weights))
+    packages = list(leaves)
+    for _ in range(limit - 1):
+        merged = [(packages[k][0] + packages[k + 1][0], packages[k][1] + packages[k + 1][1])
+                  for k in range(0, len(packages) - 1, 2)]
+        packages = sorted(leaves + merged, key=lambda p: p[0])
+    lengths = [0] * len(weights)
+    for _, syms in packages[: 2 * len(weights) - 2]:
+        for s in syms:
+            lengths[s] += 1
+    return lengths
+
+
+def deepen(lengths, weights):
+    """Lengthen the code until some symbol is >= MIN_LONGEST bits.
+
+    The two rarest symbols at the longest length move one level down and
+    the most frequent one there moves up, which keeps the Kraft sum at 1.
+    """
+    while max(lengths) < MIN_LONGEST:
+        longest = max(lengths)
+        at = sorted((weights[s], s) for s in range(len(lengths)) if lengths[s] == longest)
+        if len(at) < 3:
+            raise SystemExit("cannot deepen code")
+        lengths[at[0][1]] += 1
+        lengths[at[1][1]] += 1
+        lengths[at[-1][1]] -= 1
+    return lengths
+
+
+def kraft_ok(lengths):
+    return sum(1 << (MAX_BITS - l) for l in lengths) == 1 << MAX_BITS
+
+
+def canonical_order(lengths):
+    return [s for _, s in sorted((l, s) for s, l in enumerate(lengths))]
+
+
+def build_model(freq, scale):
+    model = []
+    for ctx in range(len(CONTEXTS)):
+        # Every symbol stays codable: add one to the scaled counts
+        weights = [f * scale + 1 for f in freq[ctx]]
+        lengths = limited_lengths(weights, MAX_BITS)
+        if max(lengths) < MIN_LONGEST:
+            lengths = deepen(lengths, weights)
+        assert kraft_ok(lengths), "incomplete code for context %d" % ctx
+        assert max(lengths) >= MIN_LONGEST
+        model.append(lengths)
+    return model
+
+
+def coded_bits(model, msg):
+    bits = 0
+    prev = 0x20
+    for b in msg:
+        s = symbol_of(b)
+        bits += model[context_of(prev)][s] + (8 if s == ESC else 0)
+        prev = b
+    return bits
+
+
+def emit(model, path, version, sources, ratio):
+    def rows(values, per_line=24):
+        out = []
+        for k in range(0, len(values), per_line):
+            out.append("        " + ", ".join("%2d" % v for v in values[k:k + per_line]) + ",")
+        return "\n".join(out)
+
+    lines = [
+        "#pragma once",
+        "",
+        "// Generated by tools/gen_entropy_model.py from %s — do not edit." % ", ".join(sources),
+        "// Expected size on the training corpus: %.1f%% of the input." % (ratio * 100),
+        "",
+        "#include <stdint.h>",
+        "",
+        "#define MESHXT_ENTROPY_MODEL_VERSION %d" % version,
+        "#define MESHXT_ENTROPY_CONTEXTS      %d" % len(CONTEXTS),
+        "#define MESHXT_ENTROPY_SYMBOLS       %d" % SYMBOLS,
+        "#define MESHXT_ENTROPY_MAX_BITS      %d" % MAX_BITS,
+        "",
+        "// Code length in bits of each symbol (byte - 0x20; %d = escape) per context" % ESC,
+        "constexpr uint8_t meshxt_entropy_lengths[MESHXT_ENTROPY_CONTEXTS][MESHXT_ENTROPY_SYMBOLS] = {",
+    ]
+    for ctx, lengths in enumerate(model):
+        lines.append("    {   // %s" % CONTEXTS[ctx])
+        lines.append(rows(lengths))
+        lines.append("    },")
+    lines += [
+        "};",
+        "",
+        "// Symbols in canonical order (by length, then value) per context",
+        "constexpr uint8_t meshxt_entropy_sorted[MESHXT_ENTROPY_CONTEXTS][MESHXT_ENTROPY_SYMBOLS] = {",
+    ]
+    for ctx, lengths in enumerate(model):
+        lines.append("    {")
+        lines.append(rows(canonical_order(lengths)))
+        lines.append("    },")
+    lines += ["};", ""]
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("corpus", nargs="*", default=[os.path.join(ROOT, "tools", "corpus", "mesh_chat.txt")])
+    ap.add_argument("-o", "--output", default=os.path.join(ROOT, "src", "meshxt", "MeshXTEntropyModel.h"))
+    ap.add_argument("--version", type=int, default=1)
+    ap.add_argument("--scale", type=int, default=4, help="corpus weight relative to the +1 prior")
+    args = ap.parse_args()
+
+    messages = read_corpus(args.corpus)
+    if not messages:
+        sys.exit("empty corpus")
+    model = build_model(count(messages), args.scale)
+
+    raw = sum(len(m) for m in messages)
+    coded = sum((coded_bits(model, m) + 7) // 8 for m in messages)
+    ratio = coded / raw
+    sources = [os.path.relpath(p, ROOT) for p in args.corpus]
+    emit(model, args.output, args.version, sources, ratio)
+
+    mid = [m for m in messages if 20 <= len(m) <= 60]
+    mid_ratio = sum((coded_bits(model, m) + 7) // 8 for m in mid) / max(1, sum(len(m) for m in mid))
+    print("%d messages, %d bytes -> %d bytes (%.1f%%); 20-60 chars: %.1f%%"
+          % (len(messages), raw, coded, ratio * 100, mid_ratio * 100))
+    print("wrote %s (model version %d)" % (os.path.relpath(args.output, ROOT), args.version))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,45 @@
+/**
+ * Arduino.h — The little of the Arduino API that host tools need
+ * © Mikoshi Ltd. — Apache 2.0
+ *
+ * Lets gateway sources that only log through Serial build on a Linux
+ * host (-Itools/host). Serial writes to stdout and counts the lines it
+ * printed, so a tool can check what was logged.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+class HostSerial {
+public:
+    void begin(unsigned long) {}
+
+    void print(const char *s) { fputs(s, stdout); }
+    void println(const char *s = "") {
+        puts(s);
+        lines()++;
+    }
+
+    void printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        va_list ap;
+        va_start(ap, fmt);
+        vprintf(fmt, ap);
+        va_end(ap);
+        if (strchr(fmt, '\n')) lines()++;
+    }
+
+    // Lines printed so far, across all translation units
+    static long &lines() {
+        static long n = 0;
+        return n;
+    }
+};
+
+static HostSerial Serial __attribute__((unused));
+
+#endif // HOST_ARDUINO_H
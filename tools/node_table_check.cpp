@@ -0,0 +1,127 @@
+/**
+ * node_table_check — Host-side check of v2 sender indices over a lossy link
+ * © Mikoshi Ltd. — Apache 2.0
+ *
+ * Plays a gateway binding Meshtastic senders to MeshXTNodeTable slots and
+ * a ground station resolving them, the way PacketTranslator does. Frames
+ * from more senders than slots leave in shuffled batches (priority and
+ * retry order), some are lost, and the gateway reboots halfway with a new
+ * generation seed. Every frame the ground credits to a node is checked
+ * against the node that sent it.
+ *
+ * The same frames also go to a receiver that ignores the generation,
+ * which is how bindings were resolved before it existed.
+ *
+ * Build & run (from the repository root):
+ *   g++ -O2 -std=c++11 -Isrc/meshxt -Isrc/gateway tools/node_table_check.cpp \
+ *       src/meshxt/MeshXTNodeTable.cpp -o node_table_check
+ *   ./node_table_check [--frames N] [--senders N] [--loss PERCENT] [--seed N]
+ */
+
+#include "MeshXTNodeTable.h"
+#include "config.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define BATCH 8     // Frames reordered together
+
+struct Frame {
+    uint32_t node;      // True sender
+    uint16_t index;
+    uint8_t  gen;
+    bool     withId;
+};
+
+struct Tally {
+    long credited;
+    long misattributed;
+    long dropped;
+};
+
+static void print_tally(const char *name, const Tally &t) {
+    printf("%-16s %10ld %14ld %10ld\n", name, t.credited, t.misattributed, t.dropped);
+}
+
+int main(int argc, char **argv) {
+    long frames = 200000;
+    int senders = 48, loss = 30;
+    unsigned seed = 5;
+
+    for (int a = 1; a < argc; a++) {
+        if (a + 1 < argc && strcmp(argv[a], "--frames") == 0)       frames = atol(argv[++a]);
+        else if (a + 1 < argc && strcmp(argv[a], "--senders") == 0) senders = atoi(argv[++a]);
+        else if (a + 1 < argc && strcmp(argv[a], "--loss") == 0)    loss = atoi(argv[++a]);
+        else if (a + 1 < argc && strcmp(argv[a], "--seed") == 0)    seed = (unsigned)atol(argv[++a]);
+        else {
+            fprintf(stderr, "usage: %s [--frames N] [--senders N] [--loss PERCENT] [--seed N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (senders < 1) senders = 1;
+
+    static MeshXTNodeSlot tx[RELAY_NODE_SLOTS], rx[RELAY_NODE_SLOTS];
+    uint32_t plain[RELAY_NODE_SLOTS];   // Receiver without generations
+    memset(rx, 0, sizeof(rx));
+    memset(plain, 0, sizeof(plain));
+    srand(seed);
+    meshxt_node_reset(tx, RELAY_NODE_SLOTS, (uint32_t)rand());
+
+    std::vector<uint32_t> nodes;
+    for (int i = 0; i < senders; i++) nodes.push_back(0x1000 + (uint32_t)i * 7919);
+
+    Tally withGen = {}, withoutGen = {};
+    std::vector<Frame> batch;
+    uint32_t now = 1000;
+
+    for (long i = 0; i < frames; i++) {
+        now += 1000;
+        if (i == frames / 2) {
+            // Reboot: the table is lost and the seed is new; the ground keeps its own
+            meshxt_node_reset(tx, RELAY_NODE_SLOTS, (uint32_t)rand());
+        }
+
+        Frame f;
+        f.node = nodes[rand() % senders];
+        int index = meshxt_node_index(tx, RELAY_NODE_SLOTS, f.node, now, RELAY_NODE_ANNOUNCE,
+                                      RELAY_NODE_REANNOUNCE, &f.withId, &f.gen);
+        if (index < 0) continue;
+        f.index = (uint16_t)index;
+        batch.push_back(f);
+        if (batch.size() < BATCH) continue;
+
+        std::random_shuffle(batch.begin(), batch.end());
+        for (const Frame &g : batch) {
+            if (rand() % 100 < loss) continue;
+
+            if (g.withId) {
+                meshxt_node_bind(rx, RELAY_NODE_SLOTS, g.index, g.node, g.gen);
+                plain[g.index] = g.node;
+                withGen.credited++;
+                withoutGen.credited++;
+                continue;
+            }
+
+            uint32_t node = meshxt_node_resolve(rx, RELAY_NODE_SLOTS, g.index, g.gen);
+            if (node == 0) withGen.dropped++;
+            else if (node != g.node) withGen.misattributed++;
+            else withGen.credited++;
+
+            node = plain[g.index];
+            if (node == 0) withoutGen.dropped++;
+            else if (node != g.node) withoutGen.misattributed++;
+            else withoutGen.credited++;
+        }
+        batch.clear();
+    }
+
+    printf("%ld frames, %d senders, %d slots, %d%% loss, batches of %d reordered, one reboot\n",
+           frames, senders, RELAY_NODE_SLOTS, loss, BATCH);
+    printf("%-16s %10s %14s %10s\n", "receiver", "credited", "misattributed", "dropped");
+    print_tally("generation", withGen);
+    print_tally("no generation", withoutGen);
+    return 0;
+}
@@ -0,0 +1,207 @@
+/**
+ * planner_check — Host-side check of PassPlanner against brute force
+ * © Mikoshi Ltd. — Apache 2.0
+ *
+ * Builds random queues of up to 16 frames with random priorities and
+ * lengths, and random pass time and duty cycle budgets. The gateway's
+ * loop is played out: PassPlanner::next() picks a frame, the frame is
+ * sent and charged to both budgets, and the plan is made again, until
+ * nothing fits. The value sent is compared with the best subset found by
+ * trying all of them, and with sending in priority order until a frame
+ * does not fit (the behaviour before the planner). Any pick that
+ * overruns a budget is a failure.
+ *
+ * Outer parity is not set, so the costs are airtime and PLANNER_TX_GAP_MS
+ * only. Data rate, values and PLANNER_* come from src/gateway/config.h.
+ *
+ * Build & run (from the repository root):
+ *   g++ -O2 -std=c++11 -Isrc/gateway -Isrc/meshxt tools/planner_check.cpp \
+ *       src/gateway/PassPlanner.cpp src/gateway/MessageQueue.cpp -o planner_check
+ *   ./planner_check [--trials N]       default 5000
+ */
+
+#include "PassPlanner.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------
+// Radio: LoRaWANTransmitter.cpp needs RadioLib, so the two methods the
+// planner calls are defined here. Keep them in step with that file.
+// ------------------------------------------------------------
+
+LoRaWANTransmitter::LoRaWANTransmitter()
+    : _initialized(false)
+    , _joined(false)
+    , _airtimeUsedMs(0)
+    , _dutyCycleWindowStart(0) {
+    memset(&_downlink, 0, sizeof(_downlink));
+}
+
+uint16_t LoRaWANTransmitter::maxPayload() const {
+#if LORAWAN_REGION == LORAWAN_REGION_US915
+    uint16_t n = LORAWAN_SF >= 10 ? 11 : LORAWAN_SF == 9 ? 53 : LORAWAN_SF == 8 ? 125 : 242;
+#else
+    uint16_t n = LORAWAN_SF >= 10 ? 51 : LORAWAN_SF == 9 ? 115 : 222;
+#endif
+    return n < LORAWAN_MAX_PAYLOAD ? n : LORAWAN_MAX_PAYLOAD;
+}
+
+uint32_t LoRaWANTransmitter::airtimeMs(uint16_t payloadLen) const {
+    const int32_t sf = LORAWAN_SF;
+    const int32_t de = sf >= 11 ? 1 : 0;
+    const int32_t pl = payloadLen + LORAWAN_OVERHEAD;
+
+    float symbolTime = (float)(1 << sf) / 125.0f;  // ms per symbol
+    float preambleTime = (8 + 4.25f) * symbolTime;
+
+    int32_t bits = 8 * pl - 4 * sf + 28 + 16;
+    int32_t div  = 4 * (sf - 2 * de);
+    int32_t blocks = bits > 0 ? (bits + div - 1) / div : 0;
+    float payloadTime = (8 + blocks * 5) * symbolTime;
+
+    return (uint32_t)(preambleTime + payloadTime + 0.999f);
+}
+
+// ------------------------------------------------------------
+// Check
+// ------------------------------------------------------------
+
+#define MAX_FRAMES 16
+
+struct Frame {
+    uint8_t  priority;
+    uint16_t len;
+    uint32_t airtime;
+    uint32_t value;
+};
+
+static uint32_t value_of(uint8_t priority) {
+    static const uint32_t values[] = { PLANNER_VALUE_EMERGENCY, PLANNER_VALUE_HIGH,
+                                       PLANNER_VALUE_NORMAL, PLANNER_VALUE_LOW };
+    return values[priority];
+}
+
+// Best value of any subset that fits both budgets
+static uint32_t brute_force(const Frame *f, int n, uint32_t passMs, uint32_t dutyMs) {
+    uint32_t best = 0;
+    for (uint32_t set = 0; set < (1u << n); set++) {
+        uint64_t pass = 0, duty = 0;
+        uint32_t value = 0;
+        for (int i = 0; i < n; i++) {
+            if (!(set & (1u << i))) continue;
+            pass += f[i].airtime + PLANNER_TX_GAP_MS;
+            duty += f[i].airtime;
+            value += f[i].value;
+        }
+        if (pass <= passMs && duty <= dutyMs && value > best) best = value;
+    }
+    return best;
+}
+
+// Priority order, oldest first, until a frame does not fit
+static uint32_t in_order(const Frame *f, int n, uint32_t passMs, uint32_t dutyMs) {
+    uint32_t value = 0;
+    for (uint8_t p = PRIORITY_EMERGENCY; p <= PRIORITY_LOW; p++) {
+        for (int i = 0; i < n; i++) {
+            if (f[i].priority != p) continue;
+            uint32_t pass = f[i].airtime + PLANNER_TX_GAP_MS;
+            if (pass > passMs || f[i].airtime > dutyMs) return value;
+            passMs -= pass;
+            dutyMs -= f[i].airtime;
+            value += f[i].value;
+        }
+    }
+    return value;
+}
+
+// The gateway's loop: plan, send the first frame, charge it, plan again
+static bool planned(MessageQueue &queue, PassPlanner &planner, const LoRaWANTransmitter &radio,
+                    uint32_t passMs, uint32_t dutyMs, uint32_t &value) {
+    value = 0;
+    while (QueueEntry *e = planner.next(queue, radio, passMs, dutyMs)) {
+        uint32_t air = radio.airtimeMs(e->payloadLen);
+        uint32_t pass = air + PLANNER_TX_GAP_MS;
+        if (pass > passMs || air > dutyMs) {
+            printf("OVERRUN len=%u airtime=%u pass left=%u duty left=%u\n",
+                   e->payloadLen, air, passMs, dutyMs);
+            return false;
+        }
+        passMs -= pass;
+        dutyMs -= air;
+        value += value_of(e->priority);
+        queue.take(e);
+        queue.release(e);
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    long trials = 5000;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--trials") == 0 && a + 1 < argc) {
+            trials = atol(argv[++a]);
+        } else {
+            fprintf(stderr, "usage: %s [--trials N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    static MessageQueue queue;
+    static PassPlanner planner;
+    LoRaWANTransmitter radio;
+    srand(42);
+
+    double sumPlan = 0, sumOrder = 0, minPlan = 1;
+    long optimal = 0, counted = 0;
+
+    for (long t = 0; t < trials; t++) {
+        int n = 1 + rand() % MAX_FRAMES;
+        Frame f[MAX_FRAMES];
+        for (int i = 0; i < n; i++) {
+            // Mostly normal traffic, some high, few emergency and low
+            int r = rand() % 20;
+            f[i].priority = r == 0 ? PRIORITY_EMERGENCY : r < 4 ? PRIORITY_HIGH
+                          : r < 17 ? PRIORITY_NORMAL : PRIORITY_LOW;
+            f[i].len      = (uint16_t)(8 + rand() % (radio.maxPayload() - 7));
+            f[i].airtime  = radio.airtimeMs(f[i].len);
+            f[i].value    = value_of(f[i].priority);
+
+            QueueEntry *e = queue.alloc(f[i].len);
+            e->id       = (uint32_t)i;
+            e->expires  = 0xFFFFFFFF;
+            e->priority = f[i].priority;
+            e->retries  = 0;
+            queue.push(e);
+        }
+
+        // Budgets from a few frames' worth up to the whole queue
+        uint32_t passMs = 1000 + rand() % (n * (PLANNER_TX_GAP_MS + 400));
+        uint32_t dutyMs = 200 + rand() % (n * 300);
+
+        uint32_t value;
+        if (!planned(queue, planner, radio, passMs, dutyMs, value)) return 1;
+        while (QueueEntry *e = queue.pop()) queue.release(e);
+
+        uint32_t best = brute_force(f, n, passMs, dutyMs);
+        if (value > best) {
+            printf("FAIL planner value %u above brute force %u\n", value, best);
+            return 1;
+        }
+        if (best == 0) continue;
+
+        double ratio = (double)value / best;
+        sumPlan += ratio;
+        sumOrder += (double)in_order(f, n, passMs, dutyMs) / best;
+        if (ratio < minPlan) minPlan = ratio;
+        if (value == best) optimal++;
+        counted++;
+    }
+
+    printf("%ld queues of 1-%d frames, SF%d, %d ms gap\n", counted, MAX_FRAMES,
+           LORAWAN_SF, PLANNER_TX_GAP_MS);
+    printf("planner:        %.2f%% of optimum on average, worst %.1f%%, optimal in %.1f%%\n",
+           100 * sumPlan / counted, 100 * minPlan, 100.0 * optimal / counted);
+    printf("priority order: %.1f%% of optimum on average\n", 100 * sumOrder / counted);
+    return 0;
+}
@@ -0,0 +1,291 @@
+/**
+ * store_check — Host-side check of the persistent queue log (QueueStore)
+ * © Mikoshi Ltd. — Apache 2.0
+ *
+ * Runs in a fresh directory under /tmp and checks:
+ *   - replay: random adds, retries and removals, then a crash. A clean
+ *     log restores exactly the queue that was flushed, retry counts
+ *     included. A log with a torn tail or a flipped bit restores only
+ *     messages that were added, with their payloads. A restored log
+ *     restores the same queue again;
+ *   - TTLs across reboots: a message keeps the age it had at the last
+ *     checkpoint, losing at most STORE_CLOCK_MS per reboot, and one
+ *     past its TTL comes back due;
+ *   - compaction failure: with the temporary file blocked, the log is
+ *     not rewritten and the failure is logged once. Once unblocked, the
+ *     rewrite still waits out STORE_COMPACT_RETRY_MS.
+ * Exits non-zero on the first failed check.
+ *
+ * Build & run (from the repository root):
+ *   g++ -O2 -std=c++11 -Itools/host -Isrc/gateway tools/store_check.cpp \
+ *       src/gateway/QueueStore.cpp src/gateway/MessageQueue.cpp -o store_check
+ *   ./store_check [--rounds N]         crash rounds, default 300
+ */
+
+#include "QueueStore.h"
+#include <Arduino.h>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef std::map<uint32_t, std::string> Snapshot;  // id -> payload, retries
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (ok) return;
+    printf("FAIL %s\n", what);
+    failures++;
+}
+
+static Snapshot snapshot(MessageQueue &q) {
+    Snapshot s;
+    for (uint8_t p = PRIORITY_EMERGENCY; p <= PRIORITY_LOW; p++) {
+        for (QueueEntry *e = q.first(p); e; e = q.next(e)) {
+            s[e->id] = std::string((const char *)q.payload(e), e->payloadLen) + (char)e->retries;
+        }
+    }
+    return s;
+}
+
+static long log_size(void) {
+    struct stat st;
+    return stat(STORE_PATH, &st) == 0 ? (long)st.st_size : -1;
+}
+
+static QueueEntry *add(MessageQueue &q, QueueStore &s, uint32_t id, uint8_t priority,
+                       uint16_t len, uint32_t ttl, uint64_t now) {
+    QueueEntry *e = q.alloc(len);
+    if (!e) return NULL;
+    e->id       = id;
+    e->priority = priority;
+    e->retries  = 0;
+    e->expires  = (uint32_t)(now / 1000) + ttl;
+    for (uint16_t b = 0; b < len; b++) q.payload(e)[b] = (uint8_t)rand();
+    q.push(e);
+    s.recordAdd(*e, q.payload(e), now);
+    return e;
+}
+
+// ------------------------------------------------------------
+// Replay after a crash
+// ------------------------------------------------------------
+
+static void check_replay(int rounds) {
+    uint32_t nextId = 1;
+    std::map<uint32_t, std::string> added;  // Every payload ever queued
+
+    for (int round = 0; round < rounds; round++) {
+        unlink(STORE_PATH);
+        MessageQueue *q = new MessageQueue;
+        QueueStore *s = new QueueStore;
+        if (!s->begin()) {
+            check(false, "log cannot be opened");
+            return;
+        }
+        s->restore(*q, 0);
+
+        uint64_t now = 1000;
+        int ops = 50 + rand() % 3000;
+        for (int i = 0; i < ops; i++) {
+            now += rand() % 3000;
+            if (rand() % 3 && !q->full()) {
+                QueueEntry *e = add(*q, *s, nextId++, rand() % 4,
+                                    1 + rand() % MAX_SATELLITE_PAYLOAD, 3600, now);
+                if (e) added[e->id] = std::string((const char *)q->payload(e), e->payloadLen);
+            } else if (QueueEntry *e = q->pop()) {
+                if (rand() % 2) {
+                    e->retries++;
+                    q->pushFront(e);
+                    s->recordRetry(*e, now);
+                } else {
+                    s->recordRemove(*e, now);
+                    q->release(e);
+                }
+            }
+            s->poll(*q, now, rand() % 2);
+            if (rand() % 20 == 0) q->compact();
+        }
+        s->flush(now);
+        Snapshot truth = snapshot(*q);
+        delete s;   // Power loss: records batched after the flush are dropped
+        delete q;
+
+        // Crash modes: clean, torn tail, one flipped bit
+        int mode = round % 3;
+        long len = log_size();
+        if (mode == 1 && len > 0) {
+            check(truncate(STORE_PATH, len - 1 - rand() % (len < 200 ? len : 200)) == 0,
+                  "truncate log");
+        } else if (mode == 2 && len > 0) {
+            FILE *f = fopen(STORE_PATH, "r+b");
+            long off = rand() % len;
+            fseek(f, off, SEEK_SET);
+            int c = fgetc(f);
+            fseek(f, off, SEEK_SET);
+            fputc(c ^ (1 << (rand() % 8)), f);
+            fclose(f);
+        }
+
+        MessageQueue q2;
+        QueueStore s2;
+        s2.begin();
+        uint16_t n = s2.restore(q2, now);
+        Snapshot got = snapshot(q2);
+        check(n == got.size(), "restore() count matches the queue");
+        if (mode == 0) {
+            check(got == truth, "clean log restores the flushed queue");
+        } else {
+            for (Snapshot::const_iterator it = got.begin(); it != got.end(); ++it) {
+                std::map<uint32_t, std::string>::const_iterator a = added.find(it->first);
+                check(a != added.end() &&
+                      it->second.compare(0, it->second.size() - 1, a->second) == 0,
+                      "damaged log restores only messages that were added");
+            }
+        }
+
+        MessageQueue q3;
+        QueueStore s3;
+        s3.begin();
+        s3.restore(q3, now);
+        check(snapshot(q3) == got, "restored log restores the same queue");
+        if (failures) return;
+    }
+    printf("replay: %d crash rounds (clean, torn, bit flip)\n", rounds);
+}
+
+// ------------------------------------------------------------
+// TTLs across reboots
+// ------------------------------------------------------------
+
+static uint32_t seconds_left(MessageQueue &q, uint64_t now) {
+    QueueEntry *e = q.first(PRIORITY_LOW);
+    return e ? e->expires - (uint32_t)(now / 1000) : 0;
+}
+
+static void check_ttl(void) {
+    const uint32_t slack = STORE_CLOCK_MS / 1000 + 5;
+    uint32_t before;
+    unlink(STORE_PATH);
+
+    // Boot 1: a two-hour message, then 100 minutes running
+    {
+        MessageQueue q;
+        QueueStore s;
+        s.begin();
+        uint64_t now = 5000;
+        s.restore(q, now);
+        add(q, s, 1, PRIORITY_LOW, 10, 7200, now);
+        for (; now < 5000 + 100 * 60000ull; now += 1000) s.poll(q, now, true);
+        before = seconds_left(q, now);
+    }
+
+    // Boot 2: the gateway clock starts again near zero
+    {
+        MessageQueue q;
+        QueueStore s;
+        s.begin();
+        uint64_t now = 3000;
+        s.restore(q, now);
+        uint32_t left = seconds_left(q, now);
+        printf("ttl: %u s left before a reboot, %u s after\n", before, left);
+        check(left >= before && left <= before + slack, "reboot keeps the message's age");
+        before = left;
+        for (; now < 3000 + 600000ull; now += 1000) s.poll(q, now, true);
+    }
+
+    // Boot 3: ten more minutes have passed on the log clock
+    {
+        MessageQueue q;
+        QueueStore s;
+        s.begin();
+        uint64_t now = 2000;
+        s.restore(q, now);
+        uint32_t left = seconds_left(q, now);
+        check(left >= before - 600 && left <= before - 600 + slack,
+              "second reboot keeps the message's age");
+        for (; now < 2000 + 3600000ull; now += 1000) s.poll(q, now, true);
+    }
+
+    // Boot 4: past the TTL, the message comes back due
+    {
+        MessageQueue q;
+        QueueStore s;
+        s.begin();
+        uint64_t now = 2000;
+        s.restore(q, now);
+        check(q.popExpired((uint32_t)(now / 1000)) != NULL, "expired message restores due");
+    }
+}
+
+// ------------------------------------------------------------
+// Compaction failure
+// ------------------------------------------------------------
+
+static void check_compaction_backoff(void) {
+    static const char tmpPath[] = STORE_PATH ".tmp";
+    unlink(STORE_PATH);
+    mkdir(tmpPath, 0755);   // The rewrite cannot create its temporary file
+
+    MessageQueue q;
+    QueueStore s;
+    s.begin();
+    uint64_t now = 1000;
+    s.restore(q, now);
+    for (uint32_t i = 0; i < 50; i++) add(q, s, i, PRIORITY_NORMAL, 100, 1000000, now);
+    while (log_size() <= STORE_COMPACT_BYTES) {
+        for (int i = 0; i < 100; i++) s.recordRetry(*q.first(PRIORITY_NORMAL), now);
+        s.flush(now);
+    }
+
+    // Long enough for a retry, short of the one after
+    const uint64_t blocked = STORE_COMPACT_RETRY_MS + STORE_COMPACT_RETRY_MS / 2;
+    long lines = HostSerial::lines();
+    uint64_t start = now;
+    for (; now < start + blocked; now += 100) s.poll(q, now, true);
+    printf("compaction: blocked for %u s, log %ld bytes, %ld line(s) logged\n",
+           (unsigned)(blocked / 1000), log_size(), HostSerial::lines() - lines);
+    check(log_size() > STORE_COMPACT_BYTES, "blocked rewrite leaves the log");
+    check(HostSerial::lines() - lines == 1, "failed rewrite is logged once");
+
+    // Unblocked: the next try waits for the backoff
+    rmdir(tmpPath);
+    s.poll(q, now, true);
+    check(log_size() > STORE_COMPACT_BYTES, "rewrite waits STORE_COMPACT_RETRY_MS");
+    now += STORE_COMPACT_RETRY_MS;
+    s.poll(q, now, true);
+    check(log_size() <= STORE_COMPACT_BYTES, "rewrite runs after the backoff");
+}
+
+int main(int argc, char **argv) {
+    int rounds = 300;
+    for (int a = 1; a < argc; a++) {
+        if (a + 1 < argc && strcmp(argv[a], "--rounds") == 0) {
+            rounds = atoi(argv[++a]);
+        } else {
+            fprintf(stderr, "usage: %s [--rounds N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    char dir[] = "/tmp/store_check.XXXXXX";
+    if (!mkdtemp(dir) || chdir(dir) != 0) {
+        perror("store_check: work directory");
+        return 2;
+    }
+    srand(9);
+
+    check_replay(rounds);
+    if (!failures) check_ttl();
+    if (!failures) check_compaction_backoff();
+
+    unlink(STORE_PATH);
+    rmdir(dir);
+    if (failures) return 1;
+    printf("all store checks passed\n");
+    return 0;
+}